@@ -0,0 +1,92 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _BOUNDEDQUEUE_H_
+#define _BOUNDEDQUEUE_H_
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// Blocking FIFO Queue holding at most 'capacity' Items,
+// for handing work to background threads with backpressure
+template <typename T>
+struct boundedQueue
+{
+    std::mutex mutex;                   // guards the fields below
+    std::condition_variable notFull;    // signals producers that an item was taken
+    std::condition_variable notEmpty;   // signals consumers that an item was added
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;                        // no more items are accepted, consumers drain the rest
+
+    boundedQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+    // adds an item, waiting while the queue is full
+    // returns false (and drops the item) once the queue is closed
+    bool push(const T & item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return closed || (items.size() < capacity); });
+
+        if (closed)
+        {
+            return false;
+        }
+
+        items.push_back(item);
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // takes the oldest item, waiting while the queue is empty
+    // returns false once the queue is closed and drained
+    bool pop(T & item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+
+        if (items.empty())
+        {
+            return false;
+        }
+
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // takes the oldest item if there is one, without waiting
+    // returns false if the queue is empty
+    bool tryPop(T & item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (items.empty())
+        {
+            return false;
+        }
+
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // stops accepting items and wakes every waiting thread
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+#endif
+
@@ -0,0 +1,412 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#define GL_GLEXT_PROTOTYPES
+#include "openGL-headers.h"
+#include "capture.h"
+#include "frameWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Capture State (never freed, see frameWriter.h)
+struct capturePipeline
+{
+    frameWriter<struct capturedFrame> writer; // their pictures are NULL until first used
+
+    // Video, the writers convert the frames in parallel and append them in order
+    int video;                               // file descriptor, -1 when writing PPM files
+    std::string videoName;
+    double videoRate;
+    int videoWidth, videoHeight;             // size of the video (set by the first frame)
+    long submitted;                          // frames queued so far
+    long appended;                           // frames written into the video so far
+    std::mutex videoMutex;                   // guards the video fields
+    std::condition_variable videoTurn;       // signals the writers that a frame was appended
+
+    capturePipeline() : writer(CAPTURE_BUFFERS), video(-1),
+                        videoRate(0.0), videoWidth(0), videoHeight(0), submitted(0), appended(0) {}
+};
+
+static struct capturePipeline * pipeline = NULL;
+
+// Asynchronous Readback into two Pixel Buffer Objects, one
+// being filled while the other one is copied out
+static int usePixelBuffers = -1; // unknown until the first frame
+static GLuint packBuffers[2];
+static int packSizes[2];
+static int packNext = 0;
+
+// Frame in a Pixel Buffer Object, not copied out yet
+static struct
+{
+    bool valid;
+    int buffer;
+    int width, height;
+    std::string fileName;
+} pending;
+
+/**
+ * writeAll - Writes a whole Buffer to a File Descriptor
+ */
+static bool writeAll(int fd, const unsigned char * data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        data += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+/**
+ * convertFrame - Converts a Frame to a Y4M Frame, the FRAME
+ *                Header and the Y, Cb and Cr Planes (BT.601)
+ */
+static void convertFrame(Pic * pic, std::vector<unsigned char> & frame)
+{
+    static const char header[] = "FRAME\n";
+    int pixels = pic->nx * pic->ny;
+
+    frame.resize(sizeof(header) - 1 + 3 * pixels);
+    memcpy(&frame[0], header, sizeof(header) - 1);
+
+    unsigned char * y = &frame[sizeof(header) - 1];
+    unsigned char * cb = y + pixels;
+    unsigned char * cr = cb + pixels;
+
+    for (int i=0; i<pixels; i++)
+    {
+        int r = pic->pix[3 * i];
+        int g = pic->pix[3 * i + 1];
+        int b = pic->pix[3 * i + 2];
+
+        y[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+        cb[i] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+        cr[i] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+    }
+}
+
+/**
+ * appendFrame - Appends a Converted Frame to the Video once
+ *               every Earlier Frame has been Appended
+ */
+static void appendFrame(const struct capturedFrame * job, const std::vector<unsigned char> & frame)
+{
+    std::unique_lock<std::mutex> lock(pipeline->videoMutex);
+    pipeline->videoTurn.wait(lock, [&] { return pipeline->appended == job->sequence; });
+
+    // The First Frame sets the Size of the Video
+    if (pipeline->videoWidth == 0)
+    {
+        char header[128];
+        int rate = (int) (pipeline->videoRate * 1000.0 + 0.5);
+
+        pipeline->videoWidth = job->pic->nx;
+        pipeline->videoHeight = job->pic->ny;
+        int length = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444\n",
+                              pipeline->videoWidth, pipeline->videoHeight, rate);
+
+        writeAll(pipeline->video, (const unsigned char *) header, length);
+    }
+
+    if ((job->pic->nx != pipeline->videoWidth) || (job->pic->ny != pipeline->videoHeight))
+    {
+        printf("Frame %ld is %dx%d, the video is %dx%d: dropped\n", job->sequence,
+               job->pic->nx, job->pic->ny, pipeline->videoWidth, pipeline->videoHeight);
+    }
+    else if (!writeAll(pipeline->video, &frame[0], frame.size()))
+    {
+        printf("Error in Saving frame %ld to %s\n", job->sequence, pipeline->videoName.c_str());
+    }
+
+    pipeline->appended++;
+    pipeline->videoTurn.notify_all();
+}
+
+/**
+ * writeFrame - Writes a Queued Frame (on one of the Writer Threads)
+ */
+static void writeFrame(struct capturedFrame * job)
+{
+    // Scratch Buffers of the Writer Thread
+    static thread_local std::vector<Pixel1> row;
+    static thread_local std::vector<unsigned char> frame;
+
+    Pic * pic = job->pic;
+    int stride = pic->nx * pic->bpp;
+
+    // Flip the Frame Top Row First
+    if (job->bottomUp)
+    {
+        row.resize(stride);
+        for (int y=0; y<pic->ny/2; y++)
+        {
+            Pixel1 * top = &pic->pix[y * stride];
+            Pixel1 * bottom = &pic->pix[(pic->ny - 1 - y) * stride];
+            memcpy(&row[0], top, stride);
+            memcpy(top, bottom, stride);
+            memcpy(bottom, &row[0], stride);
+        }
+    }
+
+    if (pipeline->video >= 0)
+    {
+        convertFrame(pic, frame);
+        appendFrame(job, frame);
+        return;
+    }
+
+    // The Suffix of the File Name Chooses the Format
+    char * fileName = (char *) job->fileName.c_str();
+    if (!pic_write(fileName, pic, pic_filename_type(fileName)))
+    {
+        printf("Error in Saving %s\n", job->fileName.c_str());
+    }
+}
+
+/**
+ * startCapture - Starts the Writer Threads
+ */
+void startCapture()
+{
+    if (pipeline != NULL)
+    {
+        return;
+    }
+
+    pipeline = new capturePipeline();
+
+    for (int i=0; i<CAPTURE_BUFFERS; i++)
+    {
+        struct capturedFrame * frame = new capturedFrame();
+        frame->pic = NULL;
+        pipeline->writer.addFrame(frame);
+    }
+
+    pipeline->writer.start(CAPTURE_WRITERS, writeFrame);
+
+    atexit(stopCapture);
+}
+
+/**
+ * startVideo - Opens the Video the Frames are Appended to
+ */
+int startVideo(const char * fileName, double rate)
+{
+    int video = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (video < 0)
+    {
+        printf("Can't create the video %s\n", fileName);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(pipeline->videoMutex);
+    pipeline->video = video;
+    pipeline->videoName = fileName;
+    pipeline->videoRate = rate;
+
+    return 1;
+}
+
+/**
+ * capturingVideo - Checks if the Frames go into a Video
+ */
+int capturingVideo()
+{
+    return (pipeline != NULL) && (pipeline->video >= 0);
+}
+
+/**
+ * acquireFrame - Takes a Free Frame of the given Size
+ *
+ * @return - Returns NULL once the Pool is Closed
+ */
+struct capturedFrame * acquireFrame(int width, int height)
+{
+    struct capturedFrame * frame = pipeline->writer.acquire();
+    if (frame == NULL)
+    {
+        return NULL;
+    }
+
+    // Allocate the Picture the first time, or after the Window was Resized
+    if ((frame->pic != NULL) && ((frame->pic->nx != width) || (frame->pic->ny != height)))
+    {
+        pic_free(frame->pic);
+        frame->pic = NULL;
+    }
+    if (frame->pic == NULL)
+    {
+        frame->pic = pic_alloc(width, height, 3, NULL);
+    }
+
+    return frame;
+}
+
+/**
+ * queueFrame - Hands a Frame to the Writers
+ */
+static void queueFrame(struct capturedFrame * frame, const char * fileName, bool bottomUp)
+{
+    frame->fileName = fileName;
+    frame->bottomUp = bottomUp;
+    frame->sequence = pipeline->submitted++;
+
+    pipeline->writer.submit(frame);
+}
+
+/**
+ * submitFrame - Queues a Frame drawn on the CPU
+ */
+void submitFrame(struct capturedFrame * frame, const char * fileName)
+{
+    queueFrame(frame, fileName, false);
+}
+
+/**
+ * checkPixelBuffers - Checks if the Context has Pixel
+ *                     Buffer Objects (OpenGL 2.1)
+ */
+static int checkPixelBuffers()
+{
+    const char * version = (const char *) glGetString(GL_VERSION);
+    const char * extensions = (const char *) glGetString(GL_EXTENSIONS);
+    int major = 0, minor = 0;
+
+    if ((version != NULL) && (sscanf(version, "%d.%d", &major, &minor) == 2) &&
+        ((major > 2) || ((major == 2) && (minor >= 1))))
+    {
+        return 1;
+    }
+
+    return (extensions != NULL) && (strstr(extensions, "GL_ARB_pixel_buffer_object") != NULL);
+}
+
+/**
+ * flushCapture - Copies the Pending Frame out of its
+ *                Pixel Buffer Object
+ */
+void flushCapture()
+{
+    if (!pending.valid)
+    {
+        return;
+    }
+    pending.valid = false;
+
+    struct capturedFrame * frame = acquireFrame(pending.width, pending.height);
+    if (frame == NULL)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[pending.buffer]);
+    void * pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels != NULL)
+    {
+        memcpy(frame->pic->pix, pixels, pending.width * pending.height * 3);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (pixels == NULL)
+    {
+        printf("Error in Saving %s\n", pending.fileName.c_str());
+        pipeline->writer.release(frame);
+        return;
+    }
+
+    queueFrame(frame, pending.fileName.c_str(), true);
+}
+
+/**
+ * captureFrame - Reads the Framebuffer back and Queues it
+ */
+void captureFrame(int width, int height, const char * fileName)
+{
+    // Tightly Packed Rows
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (usePixelBuffers < 0)
+    {
+        usePixelBuffers = checkPixelBuffers();
+        if (usePixelBuffers)
+        {
+            glGenBuffers(2, packBuffers);
+        }
+    }
+
+    // Synchronous Readback straight into a Frame
+    if (!usePixelBuffers)
+    {
+        struct capturedFrame * frame = acquireFrame(width, height);
+        if (frame == NULL)
+        {
+            return;
+        }
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, frame->pic->pix);
+        queueFrame(frame, fileName, true);
+        return;
+    }
+
+    // Start the Readback into the next Pixel Buffer Object
+    int buffer = packNext;
+    packNext = 1 - packNext;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffers[buffer]);
+    if (packSizes[buffer] != width * height * 3)
+    {
+        packSizes[buffer] = width * height * 3;
+        glBufferData(GL_PIXEL_PACK_BUFFER, packSizes[buffer], NULL, GL_STREAM_READ);
+    }
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Copy out the Previous Frame, its Readback had a Frame to Finish
+    flushCapture();
+
+    pending.valid = true;
+    pending.buffer = buffer;
+    pending.width = width;
+    pending.height = height;
+    pending.fileName = fileName;
+}
+
+/**
+ * stopCapture - Writes the Queued Frames and Stops the Writers
+ */
+void stopCapture()
+{
+    if ((pipeline == NULL) || pipeline->writer.stopped)
+    {
+        return;
+    }
+
+    pipeline->writer.stop();
+
+    if (pipeline->video >= 0)
+    {
+        close(pipeline->video);
+        pipeline->video = -1;
+    }
+}
+
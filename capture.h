@@ -0,0 +1,65 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _CAPTURE_H_
+#define _CAPTURE_H_
+
+#include <string>
+#include "pic.h"
+
+// number of reusable frames, and of frames waiting to be written
+#define CAPTURE_BUFFERS 4
+
+// number of background threads writing the frames
+#define CAPTURE_WRITERS 2
+
+// starts the writer threads (stopCapture is registered with atexit)
+void startCapture();
+
+// writes the captured frames, in order, into the single Y4M video 'fileName'
+// (YCbCr 4:4:4, 'rate' frames per second) instead of loose image files. The file
+// names given to captureFrame and submitFrame are ignored from then on.
+// Returns 0 if the file can't be created.
+int startVideo(const char * fileName, double rate);
+
+// checks if the frames go into a video
+int capturingVideo();
+
+// reads the current OpenGL framebuffer (width * height) back with a single
+// call and queues it to be written to 'fileName' (PPM, PNG or QOI, by the
+// suffix, see pic_filename_type). With pixel buffer
+// objects the readback is asynchronous, and the frame is copied out on the
+// next call (or flushCapture). Waits while all the frames are in flight.
+void captureFrame(int width, int height, const char * fileName);
+
+// copies out the frame still in a pixel buffer object and queues it
+// (needs the OpenGL context, call it before exiting)
+void flushCapture();
+
+// Reusable Frame of the Writers
+struct capturedFrame
+{
+    Pic * pic;              // pixels, allocated by acquireFrame
+    std::string fileName;
+    bool bottomUp;          // rows as glReadPixels returns them, flipped by the writer
+    long sequence;          // position of the frame in the video
+};
+
+// takes a free width * height frame to draw into on the CPU (its pic), waiting
+// while all of them are in flight (NULL once the capture stopped). Hand it to
+// submitFrame, which returns it to the pool.
+struct capturedFrame * acquireFrame(int width, int height);
+
+// queues a frame from acquireFrame (top row first) to be written to 'fileName'
+void submitFrame(struct capturedFrame * frame, const char * fileName);
+
+// waits until every queued frame is written, stops the writer threads
+// and closes the video
+void stopCapture();
+
+#endif
+
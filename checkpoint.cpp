@@ -0,0 +1,375 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "checkpoint.h"
+#include "boundedQueue.h"
+#include "frameWriter.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// Copy of the Scene taken at a Step Boundary, Waiting for the Writer
+struct checkpointState
+{
+    struct checkpointHeader header;
+    std::vector<struct checkpointBody> bodies;
+    std::vector<struct world> worlds;               // bodies as they are in memory, pointers cleared
+    std::vector<std::vector<struct point> > fields; // force field of every body (empty if shared)
+};
+
+// Checkpoint Writer State (never freed, see frameWriter.h)
+struct checkpointWriter
+{
+    boundedQueue<struct checkpointState *> pending; // the copy, once taken
+    std::thread writer;
+
+    std::string fileName;
+    int every;                          // timesteps between checkpoints, 0 if only on request
+
+    // The Copy is Owned by the Stepping Thread while not Writing
+    struct checkpointState state;
+    std::atomic<bool> writing;
+    std::atomic<bool> requested;        // a checkpoint was asked for
+    long lastStep;                      // step of the last copy, so a step is not copied twice
+    bool stopped;
+
+    checkpointWriter() : pending(1), every(0), writing(false), requested(false), lastStep(-1), stopped(false) {}
+};
+
+static struct checkpointWriter * checkpoints = NULL;
+
+/**
+ * writeState - Writes the Copy into a new File and Replaces
+ *              the Checkpoint with it once it is Complete
+ */
+static void writeState(const struct checkpointState & state)
+{
+    std::string temporary = checkpoints->fileName + ".tmp";
+    writtenFile file;
+    if (!file.open(temporary, "wb"))
+    {
+        return;
+    }
+    setvbuf(file.file, NULL, _IOFBF, CHECKPOINT_IO_BUFFER);
+
+    file.write(&state.header, sizeof(state.header));
+    for (int b=0; b<state.header.bodies; b++)
+    {
+        file.write(&state.bodies[b], sizeof(struct checkpointBody));
+        file.write(&state.worlds[b], sizeof(struct world));
+        file.write(state.fields[b].data(), state.fields[b].size() * sizeof(struct point));
+    }
+
+    // Keep the Previous Checkpoint if this one is Incomplete
+    bool closed = file.close();
+    if (!closed || file.failed || (rename(temporary.c_str(), checkpoints->fileName.c_str()) != 0))
+    {
+        printf("Error in Saving the checkpoint %s\n", checkpoints->fileName.c_str());
+        remove(temporary.c_str());
+        return;
+    }
+
+    printf("Checkpoint of step %ld (%.4f s) saved to %s\n", (long) state.header.steps, state.header.time,
+           checkpoints->fileName.c_str());
+}
+
+/**
+ * writerLoop - Main Loop of the Writer Thread, Writing the
+ *              Copies Handed over by the Stepping Thread
+ */
+static void writerLoop()
+{
+    struct checkpointState * state;
+
+    while (checkpoints->pending.pop(state))
+    {
+        writeState(*state);
+
+        // Hand the Copy back
+        checkpoints->writing.store(false, std::memory_order_release);
+    }
+}
+
+/**
+ * startCheckpoints - Starts the Writer Thread
+ */
+int startCheckpoints(const char * fileName, int every)
+{
+    if (checkpoints != NULL)
+    {
+        return 1;
+    }
+
+    // Check that the Checkpoint can be Written
+    std::string temporary = std::string(fileName) + ".tmp";
+    FILE * file = fopen(temporary.c_str(), "wb");
+    if (file == NULL)
+    {
+        printf("Can't create the checkpoint %s\n", fileName);
+        return 0;
+    }
+    fclose(file);
+    remove(temporary.c_str());
+
+    checkpoints = new checkpointWriter();
+    checkpoints->fileName = fileName;
+    checkpoints->every = every;
+
+    checkpoints->writer = std::thread(writerLoop);
+    atexit(stopCheckpoints);
+
+    return 1;
+}
+
+/**
+ * requestCheckpoint - Asks for a Checkpoint at the next Step Boundary
+ */
+void requestCheckpoint()
+{
+    if (checkpoints == NULL)
+    {
+        printf("No checkpoint file given (-checkpoint)\n");
+        return;
+    }
+
+    checkpoints->requested = true;
+}
+
+/**
+ * copyScene - Copies everything the next Timestep depends on
+ */
+static void copyScene(struct scene * scene, struct checkpointState & state)
+{
+    int count = scene->bodies.size();
+
+    struct checkpointHeader & header = state.header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+    header.version = CHECKPOINT_VERSION;
+    header.worldSize = sizeof(struct world);
+    header.bodies = count;
+    header.n = scene->n;
+    header.selfCollision = selfCollision;
+    header.continuousCollision = continuousCollision;
+    header.ccdSteps = scene->ccdSteps;
+    header.ccdClamped = scene->ccdClamped;
+    header.steps = scene->steps;
+    header.dt = scene->dt;
+    header.time = scene->time;
+
+    state.bodies.resize(count);
+    state.worlds.resize(count);
+    state.fields.resize(count);
+
+    for (int b=0; b<count; b++)
+    {
+        struct world * jello = scene->bodies[b];
+        struct checkpointBody & body = state.bodies[b];
+
+        memset(&body, 0, sizeof(body));
+        strncpy(body.file, scene->files[b].c_str(), sizeof(body.file) - 1);
+        body.offset = scene->offsets[b];
+        body.lo = scene->lo[b];
+        body.hi = scene->hi[b];
+        body.order = scene->order[b];
+        body.sharedField = -1;
+
+        // The Body as it is, without its Pointers
+        state.worlds[b] = *jello;
+        state.worlds[b].forceField = NULL;
+        state.worlds[b].hash = NULL;
+
+        // Force Fields shared by Bodies read from the same File are Kept once
+        for (int s=0; (s<b) && (jello->forceField != NULL); s++)
+        {
+            if (scene->bodies[s]->forceField == jello->forceField)
+            {
+                body.sharedField = s;
+                break;
+            }
+        }
+
+        int fieldPoints = (jello->forceField != NULL) ? jello->resolution * jello->resolution * jello->resolution : 0;
+        if (body.sharedField >= 0)
+        {
+            fieldPoints = 0;
+        }
+        state.fields[b].assign(jello->forceField, jello->forceField + fieldPoints);
+    }
+}
+
+/**
+ * checkpointScene - Hands a Copy of the Scene to the Writer
+ *                   when a Checkpoint is Due
+ */
+void checkpointScene(struct scene * scene)
+{
+    if ((checkpoints == NULL) || checkpoints->stopped)
+    {
+        return;
+    }
+
+    // Check if a Checkpoint is Due
+    if ((checkpoints->every > 0) && (scene->steps % checkpoints->every == 0) && (scene->steps != checkpoints->lastStep))
+    {
+        checkpoints->requested = true;
+    }
+
+    if (!checkpoints->requested.load() || (scene->steps == checkpoints->lastStep))
+    {
+        return;
+    }
+
+    // Take it at a later Step while the Previous one is Written
+    if (checkpoints->writing.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    copyScene(scene, checkpoints->state);
+    checkpoints->lastStep = scene->steps;
+    checkpoints->requested = false;
+
+    checkpoints->writing = true;
+    checkpoints->pending.push(&checkpoints->state);
+}
+
+/**
+ * stopCheckpoints - Writes the Pending Checkpoint and Stops the Writer
+ */
+void stopCheckpoints()
+{
+    if ((checkpoints == NULL) || checkpoints->stopped)
+    {
+        return;
+    }
+    checkpoints->stopped = true;
+
+    checkpoints->pending.close();
+    if (checkpoints->writer.joinable())
+    {
+        checkpoints->writer.join();
+    }
+}
+
+/**
+ * readCheckpoint - Reads the Scene of a Checkpoint
+ */
+int readCheckpoint(const char * fileName, struct scene * scene)
+{
+    FILE * file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        printf("Can't read the checkpoint %s\n", fileName);
+        return 0;
+    }
+
+    struct checkpointHeader header;
+    if ((fread(&header, sizeof(header), 1, file) != 1) || (memcmp(header.magic, CHECKPOINT_MAGIC, 8) != 0) ||
+        (header.version != CHECKPOINT_VERSION) || (header.bodies <= 0))
+    {
+        printf("%s is not a checkpoint\n", fileName);
+        fclose(file);
+        return 0;
+    }
+
+    // The Bodies are Stored as they are in Memory
+    if (header.worldSize != (int32_t) sizeof(struct world))
+    {
+        printf("The checkpoint %s was written by a different build\n", fileName);
+        fclose(file);
+        return 0;
+    }
+
+    // Read every Body before Changing the Scene
+    std::vector<struct checkpointBody> bodies(header.bodies);
+    std::vector<struct world *> worlds;
+    bool ok = true;
+
+    for (int b=0; ok && (b<header.bodies); b++)
+    {
+        struct checkpointBody & body = bodies[b];
+        struct world * jello = new world();
+        worlds.push_back(jello);
+
+        ok = (fread(&body, sizeof(body), 1, file) == 1) && (fread(jello, sizeof(struct world), 1, file) == 1) &&
+             (body.order >= 0) && (body.order < header.bodies) && (body.sharedField < b);
+        body.file[sizeof(body.file) - 1] = '\0';
+        jello->forceField = NULL;
+        jello->hash = NULL;
+
+        if (!ok)
+        {
+            break;
+        }
+
+        // Share the Force Field of the Earlier Body, or Read it
+        if (body.sharedField >= 0)
+        {
+            jello->forceField = worlds[body.sharedField]->forceField;
+            ok = (jello->resolution == worlds[body.sharedField]->resolution);
+        }
+        else if (jello->resolution > 0)
+        {
+            size_t fieldPoints = (size_t) jello->resolution * jello->resolution * jello->resolution;
+            jello->forceField = (struct point *) malloc(fieldPoints * sizeof(struct point));
+            ok = (jello->forceField != NULL) && (fread(jello->forceField, sizeof(struct point), fieldPoints, file) == fieldPoints);
+        }
+    }
+    fclose(file);
+
+    if (!ok)
+    {
+        printf("The checkpoint %s is cut off or damaged\n", fileName);
+        for (size_t b=0; b<worlds.size(); b++)
+        {
+            if ((b >= bodies.size()) || (bodies[b].sharedField < 0))
+            {
+                free(worlds[b]->forceField);
+            }
+            delete worlds[b];
+        }
+        return 0;
+    }
+
+    // Rebuild the Scene
+    for (int b=0; b<header.bodies; b++)
+    {
+        addBody(scene, worlds[b], bodies[b].file, bodies[b].offset);
+    }
+
+    scene->dt = header.dt;
+    scene->n = header.n;
+    scene->time = header.time;
+    scene->steps = header.steps;
+    scene->ccdSteps = header.ccdSteps;
+    scene->ccdClamped = header.ccdClamped;
+
+    for (int b=0; b<header.bodies; b++)
+    {
+        scene->order[b] = bodies[b].order;
+        scene->lo[b] = bodies[b].lo;
+        scene->hi[b] = bodies[b].hi;
+
+        // Sleeping Bodies keep the Spatial Hash of their Final Positions
+        if (worlds[b]->asleep && (header.bodies > 1))
+        {
+            updateSpatialHash(worlds[b]);
+        }
+    }
+
+    selfCollision = header.selfCollision;
+    continuousCollision = header.continuousCollision;
+
+    printf("Restarting at step %ld (%.4f s) from %s\n", (long) header.steps, header.time, fileName);
+
+    return 1;
+}
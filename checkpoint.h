@@ -0,0 +1,76 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <stdint.h>
+
+// Checkpoint File (native byte order, only read by the same build):
+//   checkpointHeader
+//   for every body: its checkpointBody, its struct world as it is in memory (with
+//   the pointers cleared), then its resolution^3 force field points unless it
+//   shares the force field of an earlier body
+// Everything the next timestep depends on is kept bit for bit, including the
+// multi-rate workspace (slowAcceleration, slowValid), the sleep state and the
+// broadphase order, so a restart continues the same trajectory.
+
+#define CHECKPOINT_MAGIC "JELLOCKP"
+#define CHECKPOINT_VERSION 1
+
+// size of the write buffer of the file
+#define CHECKPOINT_IO_BUFFER (1 << 20)
+
+struct checkpointHeader
+{
+    char magic[8];              // CHECKPOINT_MAGIC
+    int32_t version;            // CHECKPOINT_VERSION
+    int32_t worldSize;          // sizeof(struct world) of the build that wrote it
+    int32_t bodies;             // jellos in the scene
+    int32_t n;                  // timesteps per rendered frame
+    int32_t selfCollision;      // physics controls at the time of the checkpoint
+    int32_t continuousCollision;
+    int32_t ccdSteps;           // continuous collision report counters
+    int32_t ccdClamped;
+    int64_t steps;              // timesteps performed
+    double dt;                  // common timestep
+    double time;                // simulated time
+};
+
+struct checkpointBody
+{
+    char file[4096];            // world file the body was read from (for reloading)
+    struct point offset;        // offset the body was moved by from its world file
+    struct point lo, hi;        // bounding box of the broadphase
+    int32_t order;              // body at this place of the broadphase order
+    int32_t sharedField;        // earlier body whose force field this one shares, -1 if stored
+};
+
+// starts the thread writing the checkpoints of the scene to 'fileName'. A checkpoint
+// is taken every 'every' timesteps (0 = only when asked for with requestCheckpoint).
+// The file is replaced only once the new checkpoint is complete. stopCheckpoints is
+// registered with atexit. Returns 0 if the file can't be created.
+int startCheckpoints(const char * fileName, int every);
+
+// asks for a checkpoint at the next step boundary (any thread)
+void requestCheckpoint();
+
+// copies the scene for the writer if a checkpoint is due or was asked for, and
+// the previous one has been written (otherwise it is taken at a later call).
+// Call it from the thread stepping the scene, after every timestep. Does nothing
+// if no checkpoints were started.
+void checkpointScene(struct scene * scene);
+
+// writes the pending checkpoint and stops the writer
+void stopCheckpoints();
+
+// replaces the empty scene with the one in the checkpoint 'fileName', together
+// with the physics controls it was taken with. Returns 0 if it can't be read.
+int readCheckpoint(const char * fileName, struct scene * scene);
+
+#endif
+
@@ -0,0 +1,448 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "collision.h"
+#include "surfaceMesh.h"
+#include "threadPool.h"
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <stdint.h>
+
+// Contact Constants
+const double CONTACT_THICKNESS = 0.25 * (1.0/7.0); // distance at which a vertex starts pushing off a triangle
+const double BODY_CONTACT_DEPTH = (1.0/7.0);       // depth below which a vertex is no longer pushed out of another body
+const double HASH_CELL_SIZE = (1.0/7.0);           // edge length of a hash cell (one lattice spacing)
+const int HASH_BUCKETS = 1021;                     // prime number of buckets, about 3x the surface vertices
+const int EXCLUDE_DISTANCE = 2;                    // lattice distance below which vertices never collide
+const int MASK_WORDS = (SURFACE_VERTICES + 63) / 64;
+const int TRIANGLE_GRAIN = 64;                     // triangles per parallel chunk
+const int TRIANGLE_CHUNKS = (SURFACE_TRIANGLES + TRIANGLE_GRAIN - 1) / TRIANGLE_GRAIN;
+
+// Spatial Hash of the Surface Vertices
+struct spatialHash
+{
+    std::vector<int> bucket[HASH_BUCKETS];   // surface vertices in every bucket
+    int cell[SURFACE_VERTICES][3];           // hash cell currently holding every vertex
+    int slot[SURFACE_VERTICES];              // bucket currently holding every vertex
+    bool built;                              // whether the vertices have been inserted yet
+
+    struct point x[SURFACE_VERTICES];        // gathered vertex positions
+    struct point v[SURFACE_VERTICES];        // gathered vertex velocities
+
+    std::vector<contact> contacts[TRIANGLE_CHUNKS]; // contacts found by every chunk of triangles
+};
+
+// Vertices excluded from every Triangle (lattice neighbors)
+static uint64_t excluded[SURFACE_TRIANGLES][MASK_WORDS];
+static std::once_flag excludedBuilt;
+
+/**
+ * buildExclusionMask - Marks the Vertices that are within
+ *                      EXCLUDE_DISTANCE lattice steps of
+ *                      a corner of each Triangle
+ */
+static void buildExclusionMask()
+{
+    memset(excluded, 0, sizeof(excluded));
+
+    // Iterate over the Triangles
+    for (int t=0; t<SURFACE_TRIANGLES; t++)
+    {
+        // Iterate over the Surface Vertices
+        for (int s=0; s<SURFACE_VERTICES; s++)
+        {
+            // Check the Three Corners of the Triangle
+            for (int c=0; c<3; c++)
+            {
+                int * corner = surface.vertex[surface.triangle[t][c]];
+                int * vertex = surface.vertex[s];
+
+                // Check the Lattice (Chebyshev) Distance
+                if ((abs(corner[0] - vertex[0]) <= EXCLUDE_DISTANCE) &&
+                    (abs(corner[1] - vertex[1]) <= EXCLUDE_DISTANCE) &&
+                    (abs(corner[2] - vertex[2]) <= EXCLUDE_DISTANCE))
+                {
+                    excluded[t][s / 64] |= ((uint64_t)1 << (s % 64));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * hashCell - Maps a Hash Cell to its Bucket
+ */
+static int hashCell(int x, int y, int z)
+{
+    uint32_t h = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+
+    return h % HASH_BUCKETS;
+}
+
+/**
+ * cellCoordinate - Maps a Coordinate to its Hash Cell
+ */
+static int cellCoordinate(double x)
+{
+    return (int)floor(x / HASH_CELL_SIZE);
+}
+
+/**
+ * rehash - Moves the Vertices that have changed Cells
+ *          since the last pass into their new Buckets
+ */
+static void rehash(struct spatialHash * hash)
+{
+    // Iterate over the Surface Vertices
+    for (int s=0; s<SURFACE_VERTICES; s++)
+    {
+        // Get the Current Cell of the Vertex
+        int cx = cellCoordinate(hash->x[s].x);
+        int cy = cellCoordinate(hash->x[s].y);
+        int cz = cellCoordinate(hash->x[s].z);
+
+        // Skip Vertices that stayed in their Cell
+        if (hash->built && (cx == hash->cell[s][0]) && (cy == hash->cell[s][1]) && (cz == hash->cell[s][2]))
+        {
+            continue;
+        }
+
+        // Remove the Vertex from its old Bucket
+        if (hash->built)
+        {
+            std::vector<int> & old = hash->bucket[hash->slot[s]];
+            std::vector<int>::iterator it = std::find(old.begin(), old.end(), s);
+            *it = old.back();
+            old.pop_back();
+        }
+
+        // Insert the Vertex into its new Bucket
+        hash->cell[s][0] = cx;
+        hash->cell[s][1] = cy;
+        hash->cell[s][2] = cz;
+        hash->slot[s] = hashCell(cx, cy, cz);
+        hash->bucket[hash->slot[s]].push_back(s);
+    }
+
+    hash->built = true;
+}
+
+/**
+ * triangleContact - Checks if vertex x lies within CONTACT_THICKNESS
+ *                   of triangle (a,b,c), and computes the penalty
+ *                   force pushing it away from the triangle plane
+ *
+ * @param oneSided - Always push the vertex outwards (vertex and triangle
+ *                   belong to different bodies), instead of keeping it
+ *                   on the side it is currently on
+ *
+ * @return - Returns true on contact, with the barycentric
+ *           coordinates in 'bary' and the force in 'force'
+ */
+static bool triangleContact(struct point x, struct point vx,
+                            struct point a, struct point b, struct point c,
+                            struct point va, struct point vb, struct point vc,
+                            double kCollision, double dCollision, bool oneSided,
+                            double bary[3], struct point * force)
+{
+    double length;
+
+    // Get the Triangle Edges
+    point e0, e1;
+    pDIFFERENCE(b, a, e0);
+    pDIFFERENCE(c, a, e1);
+
+    // Get the Outward Unit Normal
+    point n;
+    CROSSPRODUCTp(e0, e1, n);
+    pMAG(n, length);
+    if (length < 1e-12)
+    {
+        return false;
+    }
+    pMULTIPLY(n, (1.0 / length), n);
+
+    // Get the Signed Distance from the Triangle Plane
+    point r;
+    pDIFFERENCE(x, a, r);
+    double distance;
+    DOTPRODUCTp(n, r, distance);
+
+    if ((distance >= CONTACT_THICKNESS) || (distance <= (oneSided ? -BODY_CONTACT_DEPTH : -CONTACT_THICKNESS)))
+    {
+        return false;
+    }
+
+    // Get the Barycentric Coordinates of the Projection
+    double d00, d01, d11, d20, d21;
+    DOTPRODUCTp(e0, e0, d00);
+    DOTPRODUCTp(e0, e1, d01);
+    DOTPRODUCTp(e1, e1, d11);
+    DOTPRODUCTp(r, e0, d20);
+    DOTPRODUCTp(r, e1, d21);
+    double denom = d00 * d11 - d01 * d01;
+    bary[1] = (d11 * d20 - d01 * d21) / denom;
+    bary[2] = (d00 * d21 - d01 * d20) / denom;
+    bary[0] = 1.0 - bary[1] - bary[2];
+
+    // Check the Projection lies inside the Triangle
+    if ((bary[0] < 0.0) || (bary[1] < 0.0) || (bary[2] < 0.0))
+    {
+        return false;
+    }
+
+    // Get the Velocity of the Vertex relative to the Triangle
+    point vt, vRel;
+    vt.x = bary[0] * va.x + bary[1] * vb.x + bary[2] * vc.x;
+    vt.y = bary[0] * va.y + bary[1] * vb.y + bary[2] * vc.y;
+    vt.z = bary[0] * va.z + bary[1] * vb.z + bary[2] * vc.z;
+    pDIFFERENCE(vx, vt, vRel);
+    double vNormal;
+    DOTPRODUCTp(vRel, n, vNormal);
+
+    // Push the Vertex out of another Body, or keep it on the
+    // Side of its own Surface it is currently on
+    double side = (oneSided || (distance >= 0.0)) ? 1.0 : -1.0;
+
+    // Calculate the Penalty Force kCollision * depth - dCollision * vNormal
+    // (clamped so that the damping never pulls the surfaces together)
+    double magnitude = kCollision * (CONTACT_THICKNESS - side * distance) - dCollision * vNormal * side;
+    if (magnitude < 0.0)
+    {
+        magnitude = 0.0;
+    }
+    pMULTIPLY(n, (side * magnitude), (*force));
+
+    return true;
+}
+
+/**
+ * findContacts - Finds the Contacts of the Triangles in [begin, end)
+ *                by testing them against the Vertices in the Hash
+ *                Cells overlapped by their Bounding Boxes
+ *
+ * @param hash       - Spatial hash holding the vertices
+ * @param mesh       - Spatial hash holding the triangle positions (same as 'hash' for self-collision)
+ * @param vertexBody - Body of the pair owning the vertices, stored in the contacts
+ */
+static void findContacts(struct spatialHash * hash, struct spatialHash * mesh, int begin, int end,
+                         double kCollision, double dCollision, int vertexBody,
+                         std::vector<contact> & contacts)
+{
+    std::vector<int> candidates;
+
+    // Lattice Neighbors can only touch on the same Body
+    bool self = (hash == mesh);
+
+    // Iterate over the Triangles of the Chunk
+    for (int t=begin; t<end; t++)
+    {
+        int * tri = surface.triangle[t];
+        point a = mesh->x[tri[0]];
+        point b = mesh->x[tri[1]];
+        point c = mesh->x[tri[2]];
+
+        // Get the Hash Cells overlapped by the Bounding Box of the Triangle
+        int lo[3], hi[3];
+        lo[0] = cellCoordinate(std::min(a.x, std::min(b.x, c.x)) - CONTACT_THICKNESS);
+        lo[1] = cellCoordinate(std::min(a.y, std::min(b.y, c.y)) - CONTACT_THICKNESS);
+        lo[2] = cellCoordinate(std::min(a.z, std::min(b.z, c.z)) - CONTACT_THICKNESS);
+        hi[0] = cellCoordinate(std::max(a.x, std::max(b.x, c.x)) + CONTACT_THICKNESS);
+        hi[1] = cellCoordinate(std::max(a.y, std::max(b.y, c.y)) + CONTACT_THICKNESS);
+        hi[2] = cellCoordinate(std::max(a.z, std::max(b.z, c.z)) + CONTACT_THICKNESS);
+
+        // Gather the Candidate Vertices
+        candidates.clear();
+        for (int cx=lo[0]; cx<=hi[0]; cx++)
+        {
+            for (int cy=lo[1]; cy<=hi[1]; cy++)
+            {
+                for (int cz=lo[2]; cz<=hi[2]; cz++)
+                {
+                    std::vector<int> & bucket = hash->bucket[hashCell(cx, cy, cz)];
+
+                    for (size_t n=0; n<bucket.size(); n++)
+                    {
+                        int s = bucket[n];
+                        int * cell = hash->cell[s];
+
+                        // Skip Lattice Neighbors of the Triangle
+                        if (self && (excluded[t][s / 64] & ((uint64_t)1 << (s % 64))))
+                        {
+                            continue;
+                        }
+
+                        // Skip Vertices that only share the Bucket (hash collisions),
+                        // this also keeps every vertex from being gathered twice
+                        if ((cell[0] != cx) || (cell[1] != cy) || (cell[2] != cz))
+                        {
+                            continue;
+                        }
+
+                        candidates.push_back(s);
+                    }
+                }
+            }
+        }
+
+        // Test in Vertex Order, so the Forces do not depend on the Bucket History
+        std::sort(candidates.begin(), candidates.end());
+
+        // Test the Candidates against the Triangle
+        for (size_t n=0; n<candidates.size(); n++)
+        {
+            contact hit;
+            hit.vertex = candidates[n];
+            hit.triangle = t;
+            hit.vertexBody = vertexBody;
+
+            if (triangleContact(hash->x[hit.vertex], hash->v[hit.vertex], a, b, c,
+                                mesh->v[tri[0]], mesh->v[tri[1]], mesh->v[tri[2]],
+                                kCollision, dCollision, !self, hit.bary, &hit.force))
+            {
+                contacts.push_back(hit);
+            }
+        }
+    }
+}
+
+/**
+ * applyContact - Adds the Force of a Contact to the Vertex,
+ *                and its Reaction to the Triangle Corners
+ */
+static void applyContact(contact & hit, struct point vertexForce[8][8][8], struct point triangleForce[8][8][8])
+{
+    // Push the Vertex out of the Triangle
+    int * lattice = surface.vertex[hit.vertex];
+    pSUM(vertexForce[lattice[0]][lattice[1]][lattice[2]], hit.force,
+         vertexForce[lattice[0]][lattice[1]][lattice[2]]);
+
+    // Push the Triangle Corners back, weighted by the Barycentric Coordinates
+    for (int c=0; c<3; c++)
+    {
+        point reaction;
+        pMULTIPLY(hit.force, -hit.bary[c], reaction);
+
+        lattice = surface.vertex[surface.triangle[hit.triangle][c]];
+        pSUM(triangleForce[lattice[0]][lattice[1]][lattice[2]], reaction,
+             triangleForce[lattice[0]][lattice[1]][lattice[2]]);
+    }
+}
+
+/**
+ * updateSpatialHash - Gathers the Surface Vertices of the Jello
+ *                     and moves them to their current Hash Cells
+ */
+void updateSpatialHash(struct world * jello)
+{
+    // Build the Exclusion Mask on first use
+    std::call_once(excludedBuilt, buildExclusionMask);
+
+    // Create the Spatial Hash on first use
+    if (jello->hash == NULL)
+    {
+        jello->hash = new spatialHash();
+        jello->hash->built = false;
+    }
+
+    struct spatialHash * hash = jello->hash;
+
+    // Gather the Surface Vertices
+    for (int s=0; s<SURFACE_VERTICES; s++)
+    {
+        int * lattice = surface.vertex[s];
+        hash->x[s] = jello->p[lattice[0]][lattice[1]][lattice[2]];
+        hash->v[s] = jello->v[lattice[0]][lattice[1]][lattice[2]];
+    }
+
+    // Move the Vertices that changed Cells
+    rehash(hash);
+}
+
+/**
+ * computeSelfCollision - Accumulates the Self-Collision Forces
+ *                        of the Jello into 'force'
+ */
+void computeSelfCollision(struct world * jello, struct point force[8][8][8])
+{
+    // Bring the Spatial Hash up to date
+    updateSpatialHash(jello);
+
+    struct spatialHash * hash = jello->hash;
+
+    // Find the Contacts of every Chunk of Triangles in Parallel
+    parallelFor(SURFACE_TRIANGLES, TRIANGLE_GRAIN, [&](int begin, int end)
+    {
+        std::vector<contact> & contacts = hash->contacts[begin / TRIANGLE_GRAIN];
+        contacts.clear();
+
+        findContacts(hash, hash, begin, end, jello->kCollision, jello->dCollision, 0, contacts);
+    });
+
+    // Apply the Contacts in Chunk Order, so the Result does not depend on the Thread Count
+    for (int chunk=0; chunk<TRIANGLE_CHUNKS; chunk++)
+    {
+        std::vector<contact> & contacts = hash->contacts[chunk];
+
+        for (size_t n=0; n<contacts.size(); n++)
+        {
+            applyContact(contacts[n], force, force);
+        }
+    }
+}
+
+/**
+ * findBodyContacts - Finds the Contacts between the Surface Vertices
+ *                    of each Jello and the Surface Triangles of the other
+ */
+void findBodyContacts(struct world * a, struct world * b, std::vector<contact> & contacts)
+{
+    // Use the Average Collision Spring of the two Bodies
+    double kCollision = 0.5 * (a->kCollision + b->kCollision);
+    double dCollision = 0.5 * (a->dCollision + b->dCollision);
+
+    contacts.clear();
+
+    // Vertices of the first Body against Triangles of the second
+    findContacts(a->hash, b->hash, 0, SURFACE_TRIANGLES, kCollision, dCollision, 0, contacts);
+
+    // Vertices of the second Body against Triangles of the first
+    findContacts(b->hash, a->hash, 0, SURFACE_TRIANGLES, kCollision, dCollision, 1, contacts);
+}
+
+/**
+ * applyBodyContacts - Adds the Contacts found between two
+ *                     Jellos to their Contact Forces
+ */
+void applyBodyContacts(struct world * a, struct world * b, std::vector<contact> & contacts)
+{
+    for (size_t n=0; n<contacts.size(); n++)
+    {
+        if (contacts[n].vertexBody == 0)
+        {
+            applyContact(contacts[n], a->contactForce, b->contactForce);
+        }
+        else
+        {
+            applyContact(contacts[n], b->contactForce, a->contactForce);
+        }
+    }
+}
+
+/**
+ * freeSpatialHash - Frees the Spatial Hash of the Jello
+ */
+void freeSpatialHash(struct world * jello)
+{
+    delete jello->hash;
+    jello->hash = NULL;
+}
+
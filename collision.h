@@ -0,0 +1,45 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _COLLISION_H_
+#define _COLLISION_H_
+
+#include <vector>
+
+// uniform spatial hash over the surface vertices of a jello,
+// created on the first collision pass and updated incrementally after that
+struct spatialHash;
+
+// Represents a Surface Vertex pushing against a Surface Triangle
+struct contact
+{
+    int vertex;          // surface vertex
+    int triangle;        // surface triangle
+    int vertexBody;      // body of the pair owning the vertex (0 = first, 1 = second)
+    double bary[3];      // barycentric coordinates of the vertex on the triangle
+    struct point force;  // penalty force acting on the vertex
+};
+
+// accumulates the penalty forces between the surface vertices and the
+// surface triangles of the jello that have come into contact into 'force'
+void computeSelfCollision(struct world * jello, struct point force[8][8][8]);
+
+// moves the surface vertices of the jello to their current cells in its spatial hash
+void updateSpatialHash(struct world * jello);
+
+// finds the contacts between the surface vertices of each jello and the
+// surface triangles of the other (both spatial hashes must be up to date)
+void findBodyContacts(struct world * a, struct world * b, std::vector<struct contact> & contacts);
+
+// adds the contacts found between two jellos to their contact forces
+void applyBodyContacts(struct world * a, struct world * b, std::vector<struct contact> & contacts);
+
+// frees the spatial hash of the jello
+void freeSpatialHash(struct world * jello);
+
+#endif
+
@@ -0,0 +1,178 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _DELTACODEC_H_
+#define _DELTACODEC_H_
+
+#include <math.h>
+
+// Helpers for storing Coordinates as Small Integers: a value is quantized to a
+// multiple of a fixed quantum, and stored as the difference to the previous
+// quantized value, zigzag mapped (small magnitudes of either sign become small
+// numbers) and written 7 bits per byte (small numbers take one byte). The
+// difference of two quantized values is exact, so decoding never drifts.
+
+// longest varint of a 64-bit number
+#define VARINT_MAX_BYTES 10
+
+// values of a bit-packed block, and longest packing of 'count' values
+#define PACKED_BLOCK 16
+#define PACKED_MAX_BYTES(count) ((((count) + PACKED_BLOCK - 1) / PACKED_BLOCK) * (1 + PACKED_BLOCK * 8))
+
+// returns value as a multiple of quantum
+static inline long long quantize(double value, double quantum)
+{
+    return llround(value / quantum);
+}
+
+// maps 0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ...
+static inline unsigned long long zigzag(long long value)
+{
+    return ((unsigned long long) value << 1) ^ (unsigned long long) (value >> 63);
+}
+
+// inverse of zigzag
+static inline long long unzigzag(unsigned long long value)
+{
+    return (long long) (value >> 1) ^ -(long long) (value & 1);
+}
+
+// writes value 7 bits per byte, low bits first, the high bit set on all but
+// the last byte. Returns the position after it.
+static inline unsigned char * putVarint(unsigned char * out, unsigned long long value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char) value;
+    return out;
+}
+
+// reads a varint written by putVarint from [in, end). Returns the
+// position after it, or NULL if it runs past the end.
+static inline const unsigned char * getVarint(const unsigned char * in, const unsigned char * end, unsigned long long * value)
+{
+    unsigned long long result = 0;
+    int shift = 0;
+
+    while ((in < end) && (shift < 64))
+    {
+        unsigned char byte = *in++;
+        result |= (unsigned long long) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return in;
+        }
+        shift += 7;
+    }
+
+    return NULL;
+}
+
+// writes 'count' numbers in blocks of PACKED_BLOCK: a byte with the bit width
+// of the largest number of the block, then every number of the block in that
+// many bits, low bits first (the last block holds the rest). Mostly small
+// numbers take a few bits each. Returns the position after them.
+static inline unsigned char * packBlocks(unsigned char * out, const unsigned long long * values, size_t count)
+{
+    for (size_t first=0; first<count; first+=PACKED_BLOCK)
+    {
+        size_t size = (count - first < PACKED_BLOCK) ? count - first : PACKED_BLOCK;
+
+        // Bit Width of the Block
+        unsigned long long all = 0;
+        for (size_t i=0; i<size; i++)
+        {
+            all |= values[first + i];
+        }
+        int width = 0;
+        while ((width < 64) && ((all >> width) != 0))
+        {
+            width++;
+        }
+        *out++ = (unsigned char) width;
+
+        // Numbers, through a 64-bit Accumulator
+        unsigned long long bits = 0;
+        int used = 0;
+        for (size_t i=0; (i<size) && (width > 0); i++)
+        {
+            unsigned long long value = values[first + i];
+            bits |= value << used;
+
+            if (used + width >= 64)
+            {
+                for (int b=0; b<8; b++)
+                {
+                    *out++ = (unsigned char) (bits >> (8 * b));
+                }
+                bits = (used == 0) ? 0 : value >> (64 - used);
+                used = used + width - 64;
+            }
+            else
+            {
+                used += width;
+            }
+        }
+
+        for (; used > 0; used -= 8)
+        {
+            *out++ = (unsigned char) bits;
+            bits >>= 8;
+        }
+    }
+
+    return out;
+}
+
+// reads 'count' numbers written by packBlocks from [in, end). Returns the
+// position after them, or NULL if they run past the end.
+static inline const unsigned char * unpackBlocks(const unsigned char * in, const unsigned char * end, unsigned long long * values, size_t count)
+{
+    for (size_t first=0; first<count; first+=PACKED_BLOCK)
+    {
+        size_t size = (count - first < PACKED_BLOCK) ? count - first : PACKED_BLOCK;
+
+        if (in >= end)
+        {
+            return NULL;
+        }
+        int width = *in++;
+        size_t bytes = (size * width + 7) / 8;
+        if ((width > 64) || ((size_t) (end - in) < bytes))
+        {
+            return NULL;
+        }
+
+        // Numbers, Bit by Bit from the Bytes of the Block
+        unsigned long long mask = (width == 64) ? ~0ULL : (1ULL << width) - 1;
+        size_t bit = 0;
+        for (size_t i=0; i<size; i++)
+        {
+            unsigned long long value = 0;
+            int got = 0;
+            while (got < width)
+            {
+                int shift = bit % 8;
+                int take = (8 - shift < width - got) ? 8 - shift : width - got;
+                value |= (unsigned long long) ((in[bit / 8] >> shift) & ((1 << take) - 1)) << got;
+                got += take;
+                bit += take;
+            }
+            values[first + i] = value & mask;
+        }
+        in += bytes;
+    }
+
+    return in;
+}
+
+#endif
+
@@ -0,0 +1,290 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// frameDiff utility, compares two directories of rendered PPM frames
+// (e.g. a reference run against a run after a physics or renderer change)
+// frame by frame, and exits with 1 if any frame differs by more than the
+// tolerance, so it can gate render changes
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "pic.h"
+#include "threadPool.h"
+
+// Comparison Constants
+const int CHUNK_BYTES = 16384; // bytes summed in 32 bits before moving to 64 bits (255^2 * 16384 < 2^32)
+const int DIFF_SCALE = 4;      // brightening of the differences in the diff images
+
+// Result of Comparing one Frame
+struct frameResult
+{
+    bool missing;        // not in the second directory, unreadable, or of another size
+    int maxError;        // largest difference of a channel
+    double psnr;         // peak signal to noise ratio in dB, INFINITY if identical
+};
+
+/**
+ * compareChunk - Sums the Squared Differences of two Byte Ranges, and
+ *                Finds the Largest Difference (Branch Free, so it Vectorizes)
+ */
+static unsigned int compareChunk(const Pixel1 * a, const Pixel1 * b, int size, int * maxError)
+{
+    unsigned int squares = 0;
+    int largest = 0;
+
+    for (int i=0; i<size; i++)
+    {
+        int difference = a[i] - b[i];
+        int magnitude = (difference < 0) ? -difference : difference;
+        squares += difference * difference;
+        largest = (magnitude > largest) ? magnitude : largest;
+    }
+
+    *maxError = largest;
+    return squares;
+}
+
+/**
+ * compareFrames - Computes the PSNR and the Largest Error of two Frames
+ */
+static void compareFrames(Pic * first, Pic * second, struct frameResult * result)
+{
+    size_t size = (size_t) first->nx * first->ny * 3;
+    unsigned long long squares = 0;
+    int maxError = 0;
+
+    for (size_t begin=0; begin<size; begin+=CHUNK_BYTES)
+    {
+        int length = (size - begin < (size_t) CHUNK_BYTES) ? (int) (size - begin) : CHUNK_BYTES;
+        int largest;
+        squares += compareChunk(&first->pix[begin], &second->pix[begin], length, &largest);
+        maxError = std::max(maxError, largest);
+    }
+
+    result->maxError = maxError;
+    if (squares == 0)
+    {
+        result->psnr = INFINITY;
+    }
+    else
+    {
+        double mse = (double) squares / size;
+        result->psnr = 10.0 * log10(255.0 * 255.0 / mse);
+    }
+}
+
+/**
+ * writeDiff - Writes the Brightened Differences of two Frames
+ */
+static void writeDiff(Pic * first, Pic * second, const std::string & fileName)
+{
+    Pic * diff = pic_alloc(first->nx, first->ny, 3, NULL);
+    size_t size = (size_t) first->nx * first->ny * 3;
+
+    for (size_t i=0; i<size; i++)
+    {
+        int difference = abs(first->pix[i] - second->pix[i]) * DIFF_SCALE;
+        diff->pix[i] = (difference < 255) ? difference : 255;
+    }
+
+    if (!pic_write((char *) fileName.c_str(), diff, pic_filename_type((char *) fileName.c_str())))
+    {
+        printf("Error in Saving %s\n", fileName.c_str());
+    }
+    pic_free(diff);
+}
+
+/**
+ * listFrames - Lists the PPM Files of a Directory, Sorted by Name
+ */
+static bool listFrames(const char * directory, std::vector<std::string> & names)
+{
+    DIR * dir = opendir(directory);
+    if (dir == NULL)
+    {
+        printf("Can't open the directory %s\n", directory);
+        return false;
+    }
+
+    struct dirent * entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        const char * suffix = strrchr(entry->d_name, '.');
+        if ((suffix != NULL) && (strcmp(suffix, ".ppm") == 0))
+        {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    return true;
+}
+
+/**
+ * main - Compares the Frames of two Directories
+ */
+int main(int argc, char ** argv)
+{
+    int threads = 0;
+    int tolerance = 0;
+    const char * diffDirectory = NULL;
+
+    // Parse the Options in front of the Directories
+    int arg = 1;
+    while ((arg < argc) && (argv[arg][0] == '-'))
+    {
+        if ((strcmp(argv[arg], "-threads") == 0) && (arg + 1 < argc))
+        {
+            threads = atoi(argv[++arg]);
+        }
+        else if ((strcmp(argv[arg], "-tolerance") == 0) && (arg + 1 < argc))
+        {
+            tolerance = std::max(0, atoi(argv[++arg]));
+        }
+        else if ((strcmp(argv[arg], "-diff") == 0) && (arg + 1 < argc))
+        {
+            diffDirectory = argv[++arg];
+        }
+        else
+        {
+            break;
+        }
+        arg++;
+    }
+
+    if (argc - arg != 2)
+    {
+        printf ("Usage: %s [-threads n] [-tolerance maxError] [-diff directory] firstDirectory secondDirectory\n", argv[0]);
+        printf ("Compares the PPM frames of the first directory with the frames of the same name in the second.\n");
+        exit(0);
+    }
+
+    const char * firstDirectory = argv[arg];
+    const char * secondDirectory = argv[arg + 1];
+
+    std::vector<std::string> names;
+    if (!listFrames(firstDirectory, names))
+    {
+        exit(1);
+    }
+
+    if (names.empty())
+    {
+        printf("No PPM frames in %s\n", firstDirectory);
+        exit(1);
+    }
+
+    int frames = names.size();
+    std::vector<std::string> firstFiles(frames), secondFiles(frames);
+    std::vector<char *> firstPaths(frames), secondPaths(frames);
+    for (int f=0; f<frames; f++)
+    {
+        firstFiles[f] = std::string(firstDirectory) + "/" + names[f];
+        secondFiles[f] = std::string(secondDirectory) + "/" + names[f];
+        firstPaths[f] = (char *) firstFiles[f].c_str();
+        secondPaths[f] = (char *) secondFiles[f].c_str();
+    }
+
+    startThreadPool(threads);
+
+    // Map the Frames in Blocks, the Next ones are Read ahead while
+    // the Block is Compared on the Shared Workers
+    int block = 4 * threadPoolSize();
+    Ppm_batch * firstBatch = ppm_batch_open(&firstPaths[0], frames, block);
+    Ppm_batch * secondBatch = ppm_batch_open(&secondPaths[0], frames, block);
+    std::vector<struct frameResult> results(frames);
+    std::vector<Pic *> firstPics(block), secondPics(block);
+
+    for (int start=0; start<frames; start+=block)
+    {
+        int count = std::min(block, frames - start);
+        for (int i=0; i<count; i++)
+        {
+            firstPics[i] = ppm_batch_next(firstBatch);
+            secondPics[i] = ppm_batch_next(secondBatch);
+        }
+
+        parallelFor(count, 1, [&](int begin, int end)
+        {
+            for (int i=begin; i<end; i++)
+            {
+                struct frameResult & result = results[start + i];
+                Pic * first = firstPics[i];
+                Pic * second = secondPics[i];
+
+                result.missing = (first == NULL) || (second == NULL) ||
+                                 (first->nx != second->nx) || (first->ny != second->ny);
+                if (result.missing)
+                {
+                    continue;
+                }
+
+                compareFrames(first, second, &result);
+
+                if ((diffDirectory != NULL) && (result.maxError > tolerance))
+                {
+                    std::string name = names[start + i];
+                    writeDiff(first, second, std::string(diffDirectory) + "/" + name.substr(0, name.size() - 4) + ".png");
+                }
+            }
+        });
+
+        for (int i=0; i<count; i++)
+        {
+            ppm_unmap(firstPics[i]);
+            ppm_unmap(secondPics[i]);
+        }
+    }
+
+    ppm_batch_close(firstBatch);
+    ppm_batch_close(secondBatch);
+
+    // Report the Frames over the Tolerance, and the Totals
+    int identical = 0, failed = 0, missing = 0, worst = -1;
+    for (int f=0; f<frames; f++)
+    {
+        if (results[f].missing)
+        {
+            printf("%s  missing or of another size\n", names[f].c_str());
+            missing++;
+            continue;
+        }
+
+        if (results[f].maxError == 0)
+        {
+            identical++;
+        }
+        else if (results[f].maxError > tolerance)
+        {
+            printf("%s  PSNR %6.2f dB  max error %3d\n", names[f].c_str(), results[f].psnr, results[f].maxError);
+            failed++;
+        }
+
+        if ((worst < 0) || (results[f].psnr < results[worst].psnr))
+        {
+            worst = f;
+        }
+    }
+
+    printf("%d frames: %d identical, %d over the tolerance of %d, %d missing", frames, identical, failed, tolerance, missing);
+    if ((worst >= 0) && (results[worst].maxError > 0))
+    {
+        printf(", lowest PSNR %.2f dB (%s)", results[worst].psnr, names[worst].c_str());
+    }
+    printf("\n");
+
+    return ((failed > 0) || (missing > 0)) ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _FRAMEWRITER_H_
+#define _FRAMEWRITER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include "boundedQueue.h"
+
+// Pool of Reusable Frames handed from the Thread producing them to Writer
+// Threads (captured pictures, trajectory frames, exported surfaces, streamed
+// states): the producer takes a free frame, fills it and submits it, a writer
+// writes it and it goes back to the pool. Producers wait while every frame is
+// in flight (or drop the frame with tryAcquire), so the memory stays bounded.
+//
+// The owner allocates it once and never frees it, so the writers can outlive
+// the static destructors at exit (its stop function is registered with atexit).
+template <typename Frame>
+struct frameWriter
+{
+    boundedQueue<Frame *> freeFrames;   // frames not in flight
+    boundedQueue<Frame *> frames;       // frames waiting for the writers
+    std::vector<std::thread> writers;
+    bool stopped;
+
+    frameWriter(size_t count) : freeFrames(count), frames(count), stopped(false) {}
+
+    // adds a new frame to the pool (up to the count given to the constructor)
+    void addFrame(Frame * frame)
+    {
+        freeFrames.push(frame);
+    }
+
+    // starts 'threads' writers calling write(frame) on every submitted frame,
+    // which goes back to the pool afterwards. One writer writes them in order.
+    template <typename Write>
+    void start(int threads, Write write)
+    {
+        for (int i=0; i<threads; i++)
+        {
+            writers.push_back(std::thread([this, write]
+            {
+                Frame * frame;
+                while (frames.pop(frame))
+                {
+                    write(frame);
+                    freeFrames.push(frame);
+                }
+            }));
+        }
+    }
+
+    // takes a free frame to fill, waiting while all of them are in flight
+    // returns NULL once stopped
+    Frame * acquire()
+    {
+        Frame * frame = NULL;
+        return freeFrames.pop(frame) ? frame : NULL;
+    }
+
+    // takes a free frame to fill if there is one, without waiting
+    Frame * tryAcquire()
+    {
+        Frame * frame = NULL;
+        return freeFrames.tryPop(frame) ? frame : NULL;
+    }
+
+    // queues a filled frame for the writers
+    void submit(Frame * frame)
+    {
+        frames.push(frame);
+    }
+
+    // returns a frame to the pool without writing it
+    void release(Frame * frame)
+    {
+        freeFrames.push(frame);
+    }
+
+    // takes the oldest submitted frame without waiting, for a writer thread of
+    // the owner's own (e.g. one that also waits on sockets). Hand it back with release.
+    bool tryNext(Frame *& frame)
+    {
+        return frames.tryPop(frame);
+    }
+
+    // writes the submitted frames, stops the writers and the producers
+    void stop()
+    {
+        if (stopped)
+        {
+            return;
+        }
+        stopped = true;
+
+        frames.close();
+        for (size_t i=0; i<writers.size(); i++)
+        {
+            writers[i].join();
+        }
+        writers.clear();
+        freeFrames.close();
+    }
+};
+
+// File Appended to by a Writer Thread, Reporting only the First Error
+struct writtenFile
+{
+    FILE * file;
+    std::string name;           // for the error message
+    int64_t bytes;              // bytes written so far
+    bool failed;
+
+    writtenFile() : file(NULL), bytes(0), failed(false) {}
+
+    // creates the file, returns false if it can't be created
+    bool open(const std::string & fileName, const char * mode)
+    {
+        name = fileName;
+        file = fopen(fileName.c_str(), mode);
+        if (file == NULL)
+        {
+            printf("Can't create %s\n", fileName.c_str());
+        }
+        return file != NULL;
+    }
+
+    // appends 'size' bytes
+    void write(const void * data, size_t size)
+    {
+        if ((size > 0) && (fwrite(data, 1, size, file) != size) && !failed)
+        {
+            printf("Error in Saving %s\n", name.c_str());
+            failed = true;
+        }
+        bytes += size;
+    }
+
+    // closes the file, returns false if the buffered bytes couldn't be written
+    bool close()
+    {
+        bool closed = (file == NULL) || (fclose(file) == 0);
+        file = NULL;
+        return closed;
+    }
+};
+
+#endif
+
@@ -0,0 +1,145 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#define GL_GLEXT_PROTOTYPES
+#include "openGL-headers.h"
+#include "headless.h"
+#include <stdio.h>
+
+#if defined(linux)
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// Offscreen Context
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLContext context = EGL_NO_CONTEXT;
+static GLuint framebuffer;
+static GLuint renderbuffers[2]; // color and depth
+
+/**
+ * getDisplay - Gets the Surfaceless EGL Display, falling back
+ *              to the Default Display of the EGL Driver
+ */
+static EGLDisplay getDisplay()
+{
+    // The Default Display may try to connect to a Window System
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if (getPlatformDisplay != NULL)
+    {
+        EGLDisplay surfaceless = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (surfaceless != EGL_NO_DISPLAY)
+        {
+            return surfaceless;
+        }
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+/**
+ * startHeadless - Creates the Offscreen Context and Framebuffer
+ */
+int startHeadless(int width, int height)
+{
+    // Connect to EGL
+    display = getDisplay();
+    if ((display == EGL_NO_DISPLAY) || !eglInitialize(display, NULL, NULL))
+    {
+        printf("Headless: no EGL display available\n");
+        return 0;
+    }
+
+    // Desktop OpenGL, for the Fixed-Function Pipeline
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        printf("Headless: EGL has no desktop OpenGL\n");
+        return 0;
+    }
+
+    EGLint attributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config;
+    EGLint configs = 0;
+    eglChooseConfig(display, attributes, &config, 1, &configs);
+
+    // Without a Surface there is no Default Framebuffer
+    context = eglCreateContext(display, (configs > 0) ? config : (EGLConfig) NULL, EGL_NO_CONTEXT, NULL);
+    if ((context == EGL_NO_CONTEXT) || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        printf("Headless: can't create a surfaceless OpenGL context\n");
+        return 0;
+    }
+
+    // Render into an Offscreen Framebuffer instead
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(2, renderbuffers);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("Headless: the %dx%d framebuffer is incomplete\n", width, height);
+        return 0;
+    }
+
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    printf("Headless: rendering %dx%d on %s\n", width, height, glGetString(GL_RENDERER));
+
+    return 1;
+}
+
+/**
+ * stopHeadless - Destroys the Offscreen Framebuffer and Context
+ */
+void stopHeadless()
+{
+    if (context == EGL_NO_CONTEXT)
+    {
+        return;
+    }
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(2, renderbuffers);
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+    context = EGL_NO_CONTEXT;
+}
+
+#else
+
+/**
+ * startHeadless - Headless Rendering needs EGL
+ */
+int startHeadless(int width, int height)
+{
+    printf("Headless: rendering without a window needs EGL (Linux)\n");
+    return 0;
+}
+
+/**
+ * stopHeadless - Nothing to Destroy
+ */
+void stopHeadless()
+{
+}
+
+#endif
+
@@ -0,0 +1,21 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _HEADLESS_H_
+#define _HEADLESS_H_
+
+// creates an OpenGL context without a window system (EGL surfaceless, which
+// Mesa runs on its software rasterizer), with an offscreen framebuffer of
+// width * height pixels with depth bound for drawing and reading.
+// Returns 0 if no such context is available (e.g. not on Linux).
+int startHeadless(int width, int height);
+
+// destroys the offscreen framebuffer and the context
+void stopHeadless();
+
+#endif
+
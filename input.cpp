@@ -6,39 +6,27 @@
 
 #include "jello.h"
 #include "input.h"
+#include "scene.h"
+#include "simulation.h"
+#include "tuning.h"
+#include "capture.h"
+#include "replay.h"
+#include "checkpoint.h"
+#include <string>
+#include <vector>
+#include <ctype.h>
 
 /**
- * saveScreenshot - Writes a screenshot, in the PPM format,
- *                  to the specified filename, in PPM format
+ * saveScreenshot - Queues a screenshot, in the PPM format,
+ *                  to be written to the specified filename
+ *                  in the background
  */
 void saveScreenshot(int windowWidth, int windowHeight, char *filename)
 {
     // Null check filename
     if (filename != NULL)
     {
-        // Allocate a picture buffer
-        Pic *in = pic_alloc(windowWidth, windowHeight, 3, NULL);
-
-        // Log Filename
-        printf("File to save to: %s\n", filename);
-
-        for (int i=windowHeight-1; i>=0; i--)
-        {
-            glReadPixels(0, windowHeight-i-1, windowWidth, 1, GL_RGB, GL_UNSIGNED_BYTE,
-                    &in->pix[i*in->nx*in->bpp]);
-        }
-
-        if (ppm_write(filename, in))
-        {
-            printf("File saved Successfully\n");
-        }
-        else
-        {
-            printf("Error in Saving\n");
-        }
-
-        // Free picture buffer
-        pic_free(in);
+        captureFrame(windowWidth, windowHeight, filename);
     }
 }
 
@@ -57,6 +45,9 @@ void mouseMotionDrag(int x, int y)
         Phi += vMouseDelta[0] * 0.01;
         Theta += vMouseDelta[1] * 0.01;
 
+        // Redraw from the New Camera Position
+        glutPostRedisplay();
+
         if (Phi>2*pi)
         {
             Phi -= (2*pi);
@@ -164,9 +155,52 @@ void keyboardFunc (unsigned char key, int x, int y)
             bend = 1 - bend;
             break;
 
+        // Self-collision on/off
+        case 'c':
+            selfCollision = 1 - selfCollision;
+            requestWake();
+            break;
+
+        // Continuous collision with the bounding box on/off
+        case 'd':
+            continuousCollision = 1 - continuousCollision;
+            break;
+
+        // Wake up jellos at rest
+        case 'w':
+            requestWake();
+            break;
+
+        // Select the parameter to tune (kElastic, dElastic, kCollision, dCollision, mass)
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+            selectParameter(key - '1');
+            break;
+
+        // Increase the selected parameter
+        case '+':
+        case '=':
+            tuneParameter(1.25);
+            break;
+
+        // Decrease the selected parameter
+        case '-':
+            tuneParameter(0.8);
+            break;
+
         // Pause application on/off
         case 'p':
             pause = 1 - pause;
+            notifySimulation();
+            break;
+
+        // Checkpoint the full state at the next step boundary
+        case 'k':
+            requestCheckpoint();
+            notifySimulation();
             break;
 
         // Camera zoom in
@@ -187,39 +221,208 @@ void keyboardFunc (unsigned char key, int x, int y)
         case ' ':
             saveScreenToFile = 1 - saveScreenToFile;
             break;
+
+        // Replay: one frame back / forward
+        case '[':
+            stepReplay(-1);
+            break;
+
+        case ']':
+            stepReplay(1);
+            break;
+
+        // Replay: one second back / forward
+        case ',':
+            scrubReplay(-1.0);
+            break;
+
+        case '.':
+            scrubReplay(1.0);
+            break;
+
+        // Replay: back to the start
+        case 'r':
+            rewindReplay();
+            break;
     }
+
+    // Show the Effect of the Key
+    resumeRedraw();
 }
 
 /**
- * readWorld - Reads the world parameters from a world file.
- *             The function fills the structure 'jello' with
- *             parameters read from file. The structure 'jello'
- *             will typically be declared (probably statically,
- *             not on the heap) by the caller function. Function
- *             aborts the program if can't access the file.
+ * nextNumber - Parses the next Number of a World File
+ *              from a Buffer, skipping the White Space
+ *              in front of it
  *
- * @param fileName - String containing the name of the world file, ex: jello1.w
- * @param jello    - Structure to store world data in
+ * @return - Returns false at the end of the Buffer or on Garbage
  */
-void readWorld (char *fileName, struct world *jello)
+static bool nextNumber(char *& cursor, double & value)
 {
-    int i,j,k;
-    FILE *file;
+    char * end;
+    value = strtod(cursor, &end);
+
+    // Nothing Converted
+    if (end == cursor)
+    {
+        return false;
+    }
+
+    cursor = end;
+    return true;
+}
+
+/**
+ * nextPoints - Parses 'count' Points of a World File from a Buffer
+ */
+static bool nextPoints(char *& cursor, struct point * points, int count)
+{
+    for (int n=0; n<count; n++)
+    {
+        if (!nextNumber(cursor, points[n].x) || !nextNumber(cursor, points[n].y) || !nextNumber(cursor, points[n].z))
+        {
+            return false;
+        }
+    }
 
+    return true;
+}
+
+/**
+ * parseWorld - Parses a World File into 'jello' (see readWorld
+ *              for the format). The file is read into memory
+ *              at once and its numbers are converted straight
+ *              from the buffer, which is much faster than
+ *              scanning the force field line by line.
+ *
+ * @return - Returns 1 on success, 0 if the file can't be read
+ *           or is incomplete (e.g. while it is being written)
+ */
+int parseWorld (const char *fileName, struct world *jello)
+{
     // Open the file
-    file = fopen(fileName, "r");
+    FILE *file = fopen(fileName, "rb");
 
     // Null check file
     if (file == NULL)
     {
-        // Log error statement and exit program
-        printf ("Can't open file\n");
-        exit(1);
+        return 0;
+    }
+
+    // Read the Whole File (terminated, so strtod stops at the end)
+    std::vector<char> buffer;
+    char chunk[65536];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        buffer.insert(buffer.end(), chunk, chunk + count);
+    }
+    buffer.push_back('\0');
+
+    // Close the File
+    fclose(file);
+
+    char * cursor = &buffer[0];
+    double value;
+
+    // Read integrator algorithm (at most 9 characters)
+    while (isspace((unsigned char)*cursor))
+    {
+        cursor++;
+    }
+
+    int length = 0;
+    while ((*cursor != '\0') && !isspace((unsigned char)*cursor))
+    {
+        if (length < (int)sizeof(jello->integrator) - 1)
+        {
+            jello->integrator[length++] = *cursor;
+        }
+        cursor++;
+    }
+    jello->integrator[length] = '\0';
+
+    // Read timestep size and render
+    if (!nextNumber(cursor, jello->dt) || !nextNumber(cursor, value))
+    {
+        return 0;
+    }
+    jello->n = (int)value;
+
+    // Read physical parameters
+    if (!nextNumber(cursor, jello->kElastic) || !nextNumber(cursor, jello->dElastic) ||
+        !nextNumber(cursor, jello->kCollision) || !nextNumber(cursor, jello->dCollision))
+    {
+        return 0;
+    }
+
+    // Read mass of each of the 512 points
+    if (!nextNumber(cursor, jello->mass))
+    {
+        return 0;
+    }
+    jello->invMass = 1.0 / jello->mass;
+
+    // Read info about the plane
+    if (!nextNumber(cursor, value))
+    {
+        return 0;
+    }
+    jello->incPlanePresent = (int)value;
+
+    if (jello->incPlanePresent == 1)
+    {
+        if (!nextNumber(cursor, jello->a) || !nextNumber(cursor, jello->b) ||
+            !nextNumber(cursor, jello->c) || !nextNumber(cursor, jello->d))
+        {
+            return 0;
+        }
+    }
+
+    // Read info about the force field
+    if (!nextNumber(cursor, value) || (value < 0))
+    {
+        return 0;
+    }
+    jello->resolution = (int)value;
+
+    int cells = jello->resolution * jello->resolution * jello->resolution;
+    jello->forceField = (struct point *)malloc(cells * sizeof(struct point));
+
+    if (!nextPoints(cursor, jello->forceField, cells))
+    {
+        free(jello->forceField);
+        jello->forceField = NULL;
+        return 0;
+    }
+
+    // Read initial point positions and velocities
+    if (!nextPoints(cursor, &jello->p[0][0][0], 512) || !nextPoints(cursor, &jello->v[0][0][0], 512))
+    {
+        free(jello->forceField);
+        jello->forceField = NULL;
+        return 0;
     }
 
+    return 1;
+}
+
+/**
+ * readWorld - Reads the world parameters from a world file.
+ *             The function fills the structure 'jello' with
+ *             parameters read from file. The structure 'jello'
+ *             will typically be declared (probably statically,
+ *             not on the heap) by the caller function. Function
+ *             aborts the program if can't read the file.
+ *
+ * @param fileName - String containing the name of the world file, ex: jello1.w
+ * @param jello    - Structure to store world data in
+ */
+void readWorld (char *fileName, struct world *jello)
+{
     /*
 
-  File should first contain a line specifying the integrator (EULER or RK4).
+  File should first contain a line specifying the integrator (EULER, RK4 or MULTIRATE).
   Example: EULER
 
   Then, follows one line specifying the size of the timestep for the integrator, and
@@ -273,74 +476,124 @@ void readWorld (char *fileName, struct world *jello)
 
      */
 
-    // Read integrator algorithm
-    fscanf(file,"%s\n",&jello->integrator);
+    // Parse the File
+    if (!parseWorld(fileName, jello))
+    {
+        // Log error statement and exit program
+        printf ("Can't read world file %s\n", fileName);
+        exit(1);
+    }
 
-    // Read timestep size and render
-    fscanf(file,"%lf %d\n",&jello->dt,&jello->n);
+    // No spatial hash until the first self-collision pass
+    jello->hash = NULL;
 
-    // Read physical parameters
-    fscanf(file, "%lf %lf %lf %lf\n",
-            &jello->kElastic, &jello->dElastic, &jello->kCollision, &jello->dCollision);
+    // Not touching any other body yet
+    jello->inContact = 0;
 
-    // Read mass of each of the 512 points
-    fscanf(file, "%lf\n", &jello->mass);
+    // Start awake
+    jello->asleep = 0;
+    jello->restTime = 0.0;
 
-    // Read info about the plane
-    fscanf(file, "%d\n", &jello->incPlanePresent);
-    if (jello->incPlanePresent == 1)
+    // No multi-rate accelerations computed yet
+    jello->slowValid = 0;
+    jello->clamped = 0;
+}
+
+/**
+ * readScene - Reads a scene file listing the jellos sharing the
+ *             bounding box. Every line holds a world file and the
+ *             offset x y z to move its points by. World files are
+ *             looked up relative to the scene file, and a world file
+ *             listed several times is only read once. Function aborts
+ *             the program if can't access a file.
+ *
+ * @param fileName - String containing the name of the scene file, ex: drop.scene
+ * @param scene    - Scene to add the jellos to
+ */
+void readScene (char *fileName, struct scene *scene)
+{
+    FILE *file;
+    char worldName[4096];
+    struct point offset;
+
+    // Jellos read so far, by world file
+    std::vector<std::pair<std::string, struct world *> > loaded;
+
+    // Open the file
+    file = fopen(fileName, "r");
+
+    // Null check file
+    if (file == NULL)
     {
-        fscanf(file, "%lf %lf %lf %lf\n", &jello->a, &jello->b, &jello->c, &jello->d);
+        // Log error statement and exit program
+        printf ("Can't open file\n");
+        exit(1);
     }
 
-    // Read info about the force field
-    fscanf(file, "%d\n", &jello->resolution);
-    jello->forceField =
-            (struct point *)malloc(jello->resolution*jello->resolution*jello->resolution*sizeof(struct point));
+    // Get the directory of the scene file
+    std::string directory = fileName;
+    size_t slash = directory.find_last_of('/');
+    directory = (slash == std::string::npos) ? "" : directory.substr(0, slash + 1);
 
-    if (jello->resolution != 0)
+    // Read one jello per line
+    while (fscanf(file, "%4095s %lf %lf %lf\n", worldName, &offset.x, &offset.y, &offset.z) == 4)
     {
-        for (i=0; i<= jello->resolution-1; i++)
+        std::string path = (worldName[0] == '/') ? std::string(worldName) : directory + worldName;
+        struct world *jello = new world();
+
+        // Check if the world file was already read
+        size_t n;
+        for (n = 0; n < loaded.size(); n++)
         {
-            for (j=0; j<= jello->resolution-1; j++)
+            if (loaded[n].first == path)
             {
-                for (k=0; k<= jello->resolution-1; k++)
-                {
-                    fscanf(file, "%lf %lf %lf\n",
-                            &jello->forceField[i * jello->resolution * jello->resolution + j * jello->resolution + k].x,
-                            &jello->forceField[i * jello->resolution * jello->resolution + j * jello->resolution + k].y,
-                            &jello->forceField[i * jello->resolution * jello->resolution + j * jello->resolution + k].z);
-                }
+                break;
             }
         }
-    }
 
-    // Read initial point positions
-    for (i=0; i<=7; i++)
-    {
-        for (j=0; j<=7; j++)
+        if (n < loaded.size())
         {
-            for (k=0; k<=7; k++)
-            {
-                fscanf(file, "%lf %lf %lf\n", &jello->p[i][j][k].x, &jello->p[i][j][k].y, &jello->p[i][j][k].z);
-            }
+            // Copy the jello, sharing its force field
+            *jello = *loaded[n].second;
+        }
+        else
+        {
+            // Read the world file, keeping a copy before it is moved
+            readWorld(&path[0], jello);
+            loaded.push_back(std::make_pair(path, new world(*jello)));
         }
-    }
 
-    // Read initial point velocities
-    for (i=0; i<=7; i++)
-    {
-        for (j=0; j<=7; j++)
+        // Move the jello to its place in the scene
+        for (int i=0; i<=7; i++)
         {
-            for (k=0; k<=7; k++)
+            for (int j=0; j<=7; j++)
             {
-                fscanf(file, "%lf %lf %lf\n", &jello->v[i][j][k].x, &jello->v[i][j][k].y, &jello->v[i][j][k].z);
+                for (int k=0; k<=7; k++)
+                {
+                    pSUM(jello->p[i][j][k], offset, jello->p[i][j][k]);
+                }
             }
         }
+
+        addBody(scene, jello, path.c_str(), offset);
     }
 
     // Close the File
     fclose(file);
+
+    // Free the copies of the jellos read
+    for (size_t n = 0; n < loaded.size(); n++)
+    {
+        delete loaded[n].second;
+    }
+
+    // Check for an empty scene
+    if (scene->bodies.empty())
+    {
+        // Log error statement and exit program
+        printf ("Scene file %s has no jellos\n", fileName);
+        exit(1);
+    }
 }
 
 /**
@@ -20,7 +20,14 @@ void keyboardFunc (unsigned char key, int x, int y);
 
 // read/write world files
 void readWorld (char * fileName, struct world * jello);
+
+// parses a world file without aborting, returns 1 on success and 0 if the
+// file can't be read or is incomplete (fills only the fields in the file)
+int parseWorld (const char * fileName, struct world * jello);
 void writeWorld (char * fileName, struct world * jello);
 
+// read scene files listing several jellos
+void readScene (char * fileName, struct scene * scene);
+
 #endif
 
@@ -8,12 +8,33 @@
 // Headers
 #include "jello.h"
 #include "showCube.h"
+#include "renderer.h"
+#include "headless.h"
+#include "raster.h"
+#include "capture.h"
+#include "trajectory.h"
+#include "replay.h"
 #include "input.h"
 #include "physics.h"
+#include "scene.h"
+#include "surfaceMesh.h"
+#include "threadPool.h"
+#include "simulation.h"
+#include "tuning.h"
+#include "reload.h"
+#include "checkpoint.h"
+#include "pointCache.h"
+#include "statePublisher.h"
+#include "streamServer.h"
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
+// Rendering Constants
+const double REDRAW_RATE = 60.0; // most redraws per second while the jellos move
+const unsigned int STILL_CHECK_INTERVAL = 250; // milliseconds between checks if a still scene started moving by itself
+
 // Camera parameters
 double Theta = pi/6;
 double Phi = pi/6;
@@ -32,16 +53,46 @@ int sprite = 0;
 int shear = 0;
 int bend = 0;
 int structural = 1;
-int pause = 0;
+std::atomic<int> pause(0);
 int viewingMode = 0;
 int saveScreenToFile = 0;
 
+// Draw with the immediate-mode showCube instead of the vertex buffers
+int immediateMode = 0;
+
+// Draw the headless frames with the CPU rasterizer instead of OpenGL
+int softwareRaster = 0;
+
+// Save every captureStride-th frame (redraw, or headless frame)
+int captureStride = 1;
+
+// Format of the saved frames: ppm, png or qoi
+const char * captureFormat = "ppm";
+
+// Play a recorded trajectory instead of simulating
+int replayMode = 0;
+
+// Initialize variables control
+// the physics (set by the keyboard while the physics thread runs)
+std::atomic<int> selfCollision(1);
+std::atomic<int> continuousCollision(0);
+
 struct world jello;
 
 // Width/Height of Applciation Window
 int _windowWidth;
 int _windowHeight;
 
+// Wall-clock time of the last redraw, and whether it showed
+// the final state of a paused or sleeping scene
+double _lastRedraw = 0.0;
+int _showedStill = 0;
+
+// Whether the continuous redraw is stopped, and how often it was
+// stopped (so the checks of an earlier stop end)
+int _redrawStopped = 0;
+int _redrawStops = 0;
+
 /**
  * init - Initializes camera/drawing properties
  */
@@ -66,20 +117,11 @@ void init()
 }
 
 /**
- * reshape - Called every time window is resized
- *           to update the projection matrix, and
- *           to preserve aspect ratio
+ * setProjection - Sets the Viewport and Perspective
+ *                 for an Image of w * h Pixels
  */
-void reshape(int w, int h) 
+void setProjection(int w, int h)
 {
-    // Prevent a divide by zero, when h is zero.
-    // You can't make a window of zero height.
-    if(h == 0)
-    {
-        // Set Minimum Height of Window
-        h = 1;
-    }
-
     // Setup image size
     glViewport(0, 0, w, h);
 
@@ -98,15 +140,34 @@ void reshape(int w, int h)
     // Update Member Variables
     _windowWidth = w;
     _windowHeight = h;
+}
+
+/**
+ * reshape - Called every time window is resized
+ *           to update the projection matrix, and
+ *           to preserve aspect ratio
+ */
+void reshape(int w, int h)
+{
+    // Prevent a divide by zero, when h is zero.
+    // You can't make a window of zero height.
+    if(h == 0)
+    {
+        // Set Minimum Height of Window
+        h = 1;
+    }
+
+    setProjection(w, h);
 
     // Double buffer flush
     glutPostRedisplay();
 }
 
 /**
- * display
+ * drawScene - Draws the Jellos at the given Positions (and the
+ *             Normals of their Faces) inside the Bounding Box
  */
-void display()
+void drawScene(const std::vector<struct point> & positions, const std::vector<struct point> & normals)
 {
     // Clear buffers
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -215,71 +276,268 @@ void display()
     glEnable(GL_LIGHTING);
     glEnable(GL_DEPTH_TEST);
 
-    // Show the cube
-    showCube(&jello);
+    // Show the cubes
+    for (size_t b = 0; b < positions.size() / 512; b++)
+    {
+        if (immediateMode)
+        {
+            showCube((const struct point (*)[8][8]) &positions[512 * b]);
+        }
+        else
+        {
+            renderCube(b, (const struct point (*)[8][8]) &positions[512 * b], &normals[FACE_VERTICES * b]);
+        }
+    }
 
     // Disable lighting
     glDisable(GL_LIGHTING);
 
     // Show the bounding box
-    showBoundingBox();
+    if (immediateMode)
+    {
+        showBoundingBox();
+    }
+    else
+    {
+        renderBoundingBox();
+    }
+}
+
+/**
+ * display
+ */
+void display()
+{
+    // Check if the physics thread stopped (before taking the snapshot, so it is the final one)
+    int still = simulationStill();
+
+    // Show the cubes between the two newest states published by the physics thread
+    static std::vector<struct point> positions, normals;
+    const struct snapshot * previous;
+    const struct snapshot * state = replayMode ? NULL : acquireSnapshot(&snapshots, &previous);
+    if (replayMode)
+    {
+        // Or the Recorded Frame due now
+        showReplay(positions);
+        normals.resize(FACE_VERTICES * replayBodies());
+        for (int b=0; b<replayBodies(); b++)
+        {
+            computeFaceNormals((const struct point (*)[8][8]) &positions[512 * b], &normals[FACE_VERTICES * b]);
+        }
+    }
+    else if (state != NULL)
+    {
+        // Show exactly the state the physics thread stopped in
+        if (still)
+        {
+            previous = NULL;
+        }
+
+        interpolateSnapshots(previous, state, positions, normals);
+    }
+
+    drawScene(positions, normals);
 
     glutSwapBuffers();
+
+    // Remember what was Shown
+    _lastRedraw = wallClock();
+    _showedStill = still;
 }
 
+/**
+ * checkStill - Resumes the Redraw if a Still Scene
+ *              started Moving by itself
+ */
+void checkStill(int stop)
+{
+    // The Redraw was Resumed, or Stopped again since
+    if (!_redrawStopped || (stop != _redrawStops))
+    {
+        return;
+    }
+
+    if (!simulationStill())
+    {
+        resumeRedraw();
+        return;
+    }
+
+    glutTimerFunc(STILL_CHECK_INTERVAL, checkStill, stop);
+}
+
+void paceRedraw(int);
+
 /**
  * idle
  */
 void idle()
 {
-    char s[20]="picxxxx.ppm";
+    char s[20];
     int i;
+    static int redraws = 0;
 
     // save screen to file
-    s[3] = 48 + (sprite / 1000);
-    s[4] = 48 + (sprite % 1000) / 100;
-    s[5] = 48 + (sprite % 100 ) / 10;
-    s[6] = 48 + sprite % 10;
+    sprintf(s, "pic%04d.%s", sprite, captureFormat);
 
     if (saveScreenToFile == 1)
     {
-        saveScreenshot(_windowWidth, _windowHeight, s);
-        //saveScreenToFile=0; // save only once, change this if you want continuos image generation (i.e. animation)
-        sprite++;
+        // Save every captureStride-th Redraw
+        if (redraws++ % captureStride == 0)
+        {
+            saveScreenshot(_windowWidth, _windowHeight, s);
+            //saveScreenToFile=0; // save only once, change this if you want continuos image generation (i.e. animation)
+            sprite++;
+        }
+    }
+    else
+    {
+        // Queue the last Frame still being Read Back
+        flushCapture();
     }
 
-    // Allow only 300 snapshots
-    if (sprite >= 300)
+    // Allow only 300 snapshots as loose files, a video takes any number
+    if ((sprite >= 300) && !capturingVideo())
     {
-        // Exit Application
+        // Exit Application (after the Queued Frames are Written)
+        flushCapture();
         exit(0);
     }
 
-    // Check if the Code is not Paused
-    if (pause == 0)
+    // Nothing changes while the Scene is Paused or Asleep:
+    // stop Redrawing until an Input or Window Event
+    if (_showedStill && simulationStill() && (saveScreenToFile == 0))
     {
-        // Get Integrator
-        string integrator = std::string(jello.integrator);
+        glutIdleFunc(NULL);
 
-        // Initialize Integrator Strings
-        string rk4 = "RK4";
-        string euler = "EULER";
+        // Still notice when the Scene starts Moving without Input (e.g. a Reloaded World File)
+        _redrawStopped = 1;
+        _redrawStops++;
+        glutTimerFunc(STILL_CHECK_INTERVAL, checkStill, _redrawStops);
+        return;
+    }
 
-        // Check if Integrator is Euler
-        if(integrator.compare(euler) == 0)
+    // The Jellos are stepped by the Physics Thread, Redraw at REDRAW_RATE:
+    // too early, wait for a Timer in the Event Loop instead of Sleeping
+    double wait = _lastRedraw + (1.0 / REDRAW_RATE) - wallClock();
+    if (wait > 0.0)
+    {
+        glutIdleFunc(NULL);
+        glutTimerFunc((unsigned int) ceil(wait * 1000.0), paceRedraw, 0);
+        return;
+    }
+
+    glutPostRedisplay();
+}
+
+/**
+ * paceRedraw - Restarts the Redraw once the next Frame is due
+ */
+void paceRedraw(int)
+{
+    // A Still Scene is woken up by resumeRedraw
+    if (!_redrawStopped)
+    {
+        glutIdleFunc(idle);
+    }
+}
+
+/**
+ * resumeRedraw - Restarts the Continuous Redraw after
+ *                it stopped on a Still Scene
+ */
+void resumeRedraw()
+{
+    _redrawStopped = 0;
+    glutIdleFunc(idle);
+    glutPostRedisplay();
+}
+
+/**
+ * renderHeadless - Steps the Scene on the Calling Thread (or Plays the
+ *                  Replay), and Saves a Frame every n * captureStride
+ *                  Timesteps without a Window
+ */
+void renderHeadless(int frames)
+{
+    int bodies = replayMode ? replayBodies() : jelloScene.bodies.size();
+    std::vector<struct point> positions(512 * bodies);
+    std::vector<struct point> normals(FACE_VERTICES * bodies);
+    char s[20];
+
+
+    for (sprite=0; sprite<frames; sprite++)
+    {
+        // Show the Current State, or the Recorded one
+        if (replayMode)
+        {
+            if (!replayFrame(replayFrameAt((long) sprite * jelloScene.n * captureStride), positions))
+            {
+                break;
+            }
+
+            for (int b=0; b<bodies; b++)
+            {
+                computeFaceNormals((const struct point (*)[8][8]) &positions[512 * b], &normals[FACE_VERTICES * b]);
+            }
+        }
+        else
         {
-            // Peform Euler Integration
-            Euler(&jello);
+            for (int b=0; b<bodies; b++)
+            {
+                memcpy(&positions[512 * b], jelloScene.bodies[b]->p, 512 * sizeof(struct point));
+                computeFaceNormals(jelloScene.bodies[b]->p, &normals[FACE_VERTICES * b]);
+            }
         }
-        // Check if Integrator is RK4
-        else if(integrator.compare(rk4) == 0)
+
+        // Export the Surface of the Frame
+        exportFrame(positions);
+
+        // Publish it to other Processes
+        long step = replayMode ? (long) sprite * jelloScene.n * captureStride : jelloScene.steps;
+        publishPositions(positions, step, replayMode ? step * jelloScene.dt : jelloScene.time);
+
+        // Save it under the Name the Space Bar uses
+        sprintf(s, "pic%04d.%s", sprite, captureFormat);
+        if (softwareRaster)
         {
-            // Perform Runge-Katta 4 Integration
-            RK4(&jello);
+            struct capturedFrame * frame = acquireFrame(_windowWidth, _windowHeight);
+            if (frame != NULL)
+            {
+                rasterizeScene(frame->pic, positions, normals);
+                submitFrame(frame, s);
+            }
+        }
+        else
+        {
+            drawScene(positions, normals);
+            saveScreenshot(_windowWidth, _windowHeight, s);
+        }
+
+        // Advance to the next Frame, every Run takes the same Steps
+        for (int i=0; !replayMode && (i<jelloScene.n * captureStride); i++)
+        {
+            stepScene(&jelloScene);
+            recordScene(&jelloScene, false);
+            checkpointScene(&jelloScene);
         }
     }
 
-    glutPostRedisplay();
+    // Write the Queued Frames
+    flushCapture();
+    stopCapture();
+}
+
+/**
+ * usage - Prints the Options of the Program and Exits
+ */
+static void usage(const char * program)
+{
+    printf ("Usage: %s [-ccd] [-keep] [-immediate] [-solid] [-headless frames [-raster]] [-video file.y4m]"
+            " [-format ppm|png|qoi] [-stride n] [-record file.trj [-encoding double|float|delta] [-velocities]]"
+            " [-checkpoint file.ckp [-every steps]] [-export name [-gltf]] [-shm /name] [-stream socket] [-size WxH]"
+            " [worldfile | scenefile | -replay trajectory | -restart checkpoint]\n", program);
+    exit(0);
 }
 
 /**
@@ -287,17 +545,351 @@ void idle()
  */
 int main (int argc, char ** argv)
 {
-    // Check if less than 2 Arguments
-    if (argc < 2)
+    // Keep the Positions and Velocities when the World File is Reloaded
+    int keepState = 0;
+
+    // Frames to Render without a Window, and their Size
+    int headlessFrames = 0;
+    int width = 640;
+    int height = 480;
+
+    // Single Video the Frames are Written to, instead of PPM Files
+    const char * videoFile = NULL;
+
+    // Trajectory of every Timestep, and how it is Stored
+    const char * trajectoryFile = NULL;
+    int trajectoryEncoding = TRAJECTORY_DOUBLE;
+    int trajectoryVelocities = 0;
+
+    // Checkpoint of the Full State, how often it is Taken, and whether
+    // the File is a Checkpoint to Restart from
+    const char * checkpointFile = NULL;
+    int checkpointEvery = 0;
+    int restart = 0;
+
+    // Base Name of the Exported Surface Mesh and Point Cache, and whether
+    // it is also Exported as glTF
+    const char * exportName = NULL;
+    int exportGltf = 0;
+
+    // Shared Memory the State is Published to for other Processes
+    const char * sharedName = NULL;
+
+    // UNIX Domain Socket the State is Streamed to
+    const char * streamPath = NULL;
+
+    // Parse the Options in front of the File
+    int arg = 1;
+    while ((arg < argc) && (argv[arg][0] == '-'))
+    {
+        // Continuous Collision with the Bounding Box
+        if (strcmp(argv[arg], "-ccd") == 0)
+        {
+            continuousCollision = 1;
+        }
+        // Keep the State on Reload
+        else if (strcmp(argv[arg], "-keep") == 0)
+        {
+            keepState = 1;
+        }
+        // Draw in Immediate Mode
+        else if (strcmp(argv[arg], "-immediate") == 0)
+        {
+            immediateMode = 1;
+        }
+        // Render Frames without a Window
+        else if ((strcmp(argv[arg], "-headless") == 0) && (arg + 1 < argc))
+        {
+            headlessFrames = std::max(0, atoi(argv[++arg]));
+        }
+        // Render the Headless Frames on the CPU
+        else if (strcmp(argv[arg], "-raster") == 0)
+        {
+            softwareRaster = 1;
+        }
+        // Start in Triangle Mode
+        else if (strcmp(argv[arg], "-solid") == 0)
+        {
+            viewingMode = 1;
+        }
+        // Write the Frames into a Video
+        else if ((strcmp(argv[arg], "-video") == 0) && (arg + 1 < argc))
+        {
+            videoFile = argv[++arg];
+        }
+        // Format of the Saved Frames
+        else if ((strcmp(argv[arg], "-format") == 0) && (arg + 1 < argc))
+        {
+            captureFormat = argv[++arg];
+            if ((strcmp(captureFormat, "ppm") != 0) && (strcmp(captureFormat, "png") != 0) &&
+                (strcmp(captureFormat, "qoi") != 0))
+            {
+                printf ("Unknown frame format %s (ppm, png or qoi)\n", captureFormat);
+                exit(0);
+            }
+        }
+        // Save every Nth Frame
+        else if ((strcmp(argv[arg], "-stride") == 0) && (arg + 1 < argc))
+        {
+            captureStride = std::max(1, atoi(argv[++arg]));
+        }
+        // Record every Timestep
+        else if ((strcmp(argv[arg], "-record") == 0) && (arg + 1 < argc))
+        {
+            trajectoryFile = argv[++arg];
+        }
+        // Values of the Recording
+        else if ((strcmp(argv[arg], "-encoding") == 0) && (arg + 1 < argc))
+        {
+            arg++;
+            if (strcmp(argv[arg], "double") == 0)
+            {
+                trajectoryEncoding = TRAJECTORY_DOUBLE;
+            }
+            else if (strcmp(argv[arg], "float") == 0)
+            {
+                trajectoryEncoding = TRAJECTORY_FLOAT;
+            }
+            else if (strcmp(argv[arg], "delta") == 0)
+            {
+                trajectoryEncoding = TRAJECTORY_DELTA;
+            }
+            else
+            {
+                printf ("Unknown trajectory encoding %s (double, float or delta)\n", argv[arg]);
+                exit(0);
+            }
+        }
+        // Record the Velocities too
+        else if (strcmp(argv[arg], "-velocities") == 0)
+        {
+            trajectoryVelocities = 1;
+        }
+        // Play a Recorded Trajectory
+        else if (strcmp(argv[arg], "-replay") == 0)
+        {
+            replayMode = 1;
+        }
+        // Write Checkpoints of the Full State
+        else if ((strcmp(argv[arg], "-checkpoint") == 0) && (arg + 1 < argc))
+        {
+            checkpointFile = argv[++arg];
+        }
+        // Timesteps between Checkpoints
+        else if ((strcmp(argv[arg], "-every") == 0) && (arg + 1 < argc))
+        {
+            checkpointEvery = std::max(0, atoi(argv[++arg]));
+        }
+        // Continue from a Checkpoint
+        else if (strcmp(argv[arg], "-restart") == 0)
+        {
+            restart = 1;
+        }
+        // Export the Surface for other Programs
+        else if ((strcmp(argv[arg], "-export") == 0) && (arg + 1 < argc))
+        {
+            exportName = argv[++arg];
+        }
+        // Export as glTF too
+        else if (strcmp(argv[arg], "-gltf") == 0)
+        {
+            exportGltf = 1;
+        }
+        // Publish the State in Shared Memory
+        else if ((strcmp(argv[arg], "-shm") == 0) && (arg + 1 < argc))
+        {
+            sharedName = argv[++arg];
+        }
+        // Stream the State over a Socket
+        else if ((strcmp(argv[arg], "-stream") == 0) && (arg + 1 < argc))
+        {
+            streamPath = argv[++arg];
+        }
+        // Size of the Frames
+        else if ((strcmp(argv[arg], "-size") == 0) && (arg + 1 < argc))
+        {
+            if ((sscanf(argv[++arg], "%dx%d", &width, &height) != 2) || (width <= 0) || (height <= 0))
+            {
+                printf ("Bad frame size %s\n", argv[arg]);
+                exit(0);
+            }
+        }
+        else
+        {
+            printf ("Unknown option %s\n", argv[arg]);
+            usage(argv[0]);
+        }
+
+        arg++;
+    }
+
+    // Check if the File is Missing
+    if (arg >= argc)
     {
         // Log Error Statement and Exit Program
         printf ("Oops! You didn't say the jello world file!\n");
-        printf ("Usage: %s [worldfile]\n", argv[0]);
-        exit(0);
+        usage(argv[0]);
+    }
+
+    // The Image Files are Numbered with 4 Digits
+    if (videoFile == NULL)
+    {
+        headlessFrames = std::min(headlessFrames, 10000);
+    }
+
+    // Build the Surface Mesh used for Collisions
+    buildSurfaceMesh();
+
+    // Check for a Scene File listing several Jellos
+    char * suffix = strrchr(argv[arg], '.');
+    if (replayMode)
+    {
+        // Map in the Trajectory, no Jellos are Simulated
+        if (!openReplay(argv[arg]))
+        {
+            exit(1);
+        }
+
+        jelloScene.dt = replayTimestep();
+        jelloScene.n = replayStride();
+    }
+    else if (restart)
+    {
+        // Continue the Scene of the Checkpoint where it was Taken
+        if (!readCheckpoint(argv[arg], &jelloScene))
+        {
+            exit(1);
+        }
+    }
+    else if ((suffix != NULL) && (strcmp(suffix, ".scene") == 0))
+    {
+        // Read in Scene from Scene File
+        readScene(argv[arg], &jelloScene);
+    }
+    else
+    {
+        // Read in Scene from World File
+        readWorld(argv[arg], &jello);
+
+        struct point origin;
+        origin.x = 0.0;
+        origin.y = 0.0;
+        origin.z = 0.0;
+        addBody(&jelloScene, &jello, argv[arg], origin);
     }
 
-    // Read in Scene from World File
-    readWorld(argv[1], &jello);
+    // Start the Shared Worker Threads, and the Threads Writing the Screenshots
+    startThreadPool(0);
+    startCapture();
+
+    // Play the Video at the Pace the Frames were Captured: in Simulated
+    // Time for Headless Frames, at the Redraw Rate for the Window
+    if (videoFile != NULL)
+    {
+        double rate = REDRAW_RATE / captureStride;
+        if (headlessFrames > 0)
+        {
+            rate = 1.0 / (jelloScene.dt * jelloScene.n * captureStride);
+        }
+
+        if (!startVideo(videoFile, rate))
+        {
+            exit(1);
+        }
+    }
+
+    // Record the Timesteps (stopped at Exit after the Physics Thread)
+    if ((trajectoryFile != NULL) && !replayMode && !startRecorder(trajectoryFile, &jelloScene, trajectoryEncoding, trajectoryVelocities))
+    {
+        exit(1);
+    }
+
+    // Export the Surface at every Headless Frame, or every n Timesteps
+    // (stopped at Exit after the Physics Thread)
+    if (exportName != NULL)
+    {
+        if (replayMode && (headlessFrames == 0))
+        {
+            printf ("A replay is exported with -headless\n");
+            exit(0);
+        }
+
+        int bodies = replayMode ? replayBodies() : jelloScene.bodies.size();
+        double frameTime = jelloScene.dt * jelloScene.n * ((headlessFrames > 0) ? captureStride : 1);
+        if (!startExport(exportName, bodies, frameTime, exportGltf))
+        {
+            exit(1);
+        }
+    }
+
+    // Publish every Frame in Shared Memory (closed at Exit after the Physics Thread)
+    if (sharedName != NULL)
+    {
+        int bodies = replayMode ? replayBodies() : jelloScene.bodies.size();
+        int every = jelloScene.n * ((headlessFrames > 0) ? captureStride : 1);
+        if (!startPublisher(sharedName, bodies, jelloScene.dt, every))
+        {
+            exit(1);
+        }
+    }
+
+    // Stream every Frame to the Clients of a Socket (stopped at Exit after the Physics Thread)
+    if (streamPath != NULL)
+    {
+        int bodies = replayMode ? replayBodies() : jelloScene.bodies.size();
+        int every = jelloScene.n * ((headlessFrames > 0) ? captureStride : 1);
+        if (!startStreaming(streamPath, bodies, jelloScene.dt, every))
+        {
+            exit(1);
+        }
+    }
+
+    // Write Checkpoints (stopped at Exit after the Physics Thread)
+    if ((checkpointFile != NULL) && !replayMode && !startCheckpoints(checkpointFile, checkpointEvery))
+    {
+        exit(1);
+    }
+
+    // Render the Frames Offscreen, stepping the Jellos in Order
+    if ((headlessFrames > 0) && softwareRaster)
+    {
+        // No OpenGL at all
+        _windowWidth = width;
+        _windowHeight = height;
+        renderHeadless(headlessFrames);
+        return(0);
+    }
+    else if (headlessFrames > 0)
+    {
+        if (!startHeadless(width, height))
+        {
+            exit(1);
+        }
+
+        init();
+        setProjection(width, height);
+        if (!immediateMode)
+        {
+            startRenderer(replayMode ? replayBodies() : jelloScene.bodies.size());
+        }
+
+        renderHeadless(headlessFrames);
+
+        stopHeadless();
+        return(0);
+    }
+
+    // Start Stepping the Jellos, with Parameters Tunable from the Keyboard
+    // and Reloaded when their World Files are Saved
+    if (!replayMode)
+    {
+        startTuning(&jelloScene);
+        startReload(&jelloScene, keepState);
+
+        // The Initial State is the First Exported Frame
+        exportScene(&jelloScene);
+        startSimulation(&jelloScene);
+    }
 
     // Initialize GLUT
     glutInit(&argc,argv);
@@ -306,8 +898,8 @@ int main (int argc, char ** argv)
     glutInitDisplayMode (GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
 
     // Set window size and poistion
-    _windowWidth = 640;
-    _windowHeight = 480;
+    _windowWidth = width;
+    _windowHeight = height;
     glutInitWindowSize(_windowWidth, _windowHeight);
     glutInitWindowPosition(0,0);
 
@@ -326,6 +918,12 @@ int main (int argc, char ** argv)
     // Do Initialization
     init();
 
+    // Build the Vertex Buffers of the Jellos
+    if (!immediateMode)
+    {
+        startRenderer(replayMode ? replayBodies() : jelloScene.bodies.size());
+    }
+
     glutMainLoop();
     return(0);
 }
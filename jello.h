@@ -16,6 +16,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 #include "openGL-headers.h"
 #include "pic.h"
 
@@ -41,11 +42,18 @@ struct point
 };
 
 // these variables control what is displayed on the screen
-extern int shear, bend, structural, pause, viewingMode, saveScreenToFile;
+extern int shear, bend, structural, viewingMode, saveScreenToFile;
+
+// these variables are set by the keyboard and read by the physics thread
+extern std::atomic<int> pause;
+extern std::atomic<int> selfCollision, continuousCollision;
+
+// restarts the continuous redraw, which stops while the jellos are paused or at rest
+void resumeRedraw();
 
 struct world
 {
-  char integrator[10]; // "RK4" or "Euler"
+  char integrator[10]; // "RK4", "Euler" or "MULTIRATE"
   double dt; // timestep, e.g.. 0.001
   int n; // display only every nth timepoint
   double kElastic; // Hook's elasticity coefficient for all springs except collision springs
@@ -53,12 +61,21 @@ struct world
   double kCollision; // Hook's elasticity coefficient for collision springs
   double dCollision; // Damping coefficient collision springs
   double mass; // mass of each of the 512 control points, mass assumed to be equal for every control point
+  double invMass; // 1 / mass, recomputed whenever the mass changes
   int incPlanePresent; // Is the inclined plane present? 1 = YES, 0 = NO (always NO in this assignment)
   double a,b,c,d; // inclined plane has equation a * x + b * y + c * z + d = 0; if no inclined plane, these four fields are not used
   int resolution; // resolution for the 3d grid specifying the external force field; value of 0 means that there is no force field
   struct point * forceField; // pointer to the array of values of the force field
   struct point p[8][8][8]; // position of the 512 control points
   struct point v[8][8][8]; // velocities of the 512 control points
+  struct spatialHash * hash; // spatial hash for self-collision, NULL until the first self-collision pass
+  int inContact; // Is the jello touching another body? 1 = YES, 0 = NO
+  struct point contactForce[8][8][8]; // forces from the other bodies, held constant over a timestep
+  int asleep; // Is the jello at rest and no longer integrated? 1 = YES, 0 = NO
+  double restTime; // time the jello has stayed below the rest thresholds
+  struct point slowAcceleration[8][8][8]; // multi-rate: accelerations of all forces except the walls at the current positions
+  int slowValid; // Is slowAcceleration up to date? 1 = YES, 0 = NO
+  int clamped; // number of points stopped at the bounding box by the last continuous collision pass
 };
 
 // Represents the Particle
@@ -8,9 +8,11 @@
 // Headers
 #include "jello.h"
 #include "physics.h"
+#include "collision.h"
 #include <string>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 // Rest Length Constants
 const double COLLISION_REST_LENGTH = 0.0;
@@ -19,6 +21,13 @@ const double SHEAR_MAIN_REST_LENGTH = (1.0/7.0) * (sqrt(3));
 const double SHEAR_SIDE_REST_LENGTH = (1.0/7.0) * (sqrt(2));
 const double BEND_REST_LENGTH = (2.0/7.0);
 
+// Continuous Collision Constants
+const double BOX_SIZE = 2.0;                 // the bounding box spans -2 to 2 on every axis
+const double CCD_THICKNESS = 0.25 * (1.0/7.0); // penetration left to the collision springs
+
+// Multi-Rate Constants
+const int MULTIRATE_MAX_SUBSTEPS = 64; // most substeps a contact point takes per timestep
+
 /**
  * calcDampForce - Calculates the Damping Force
  *                 on a Mass Point
@@ -874,16 +883,25 @@ struct point processBendSprings(int i, int j, int k, struct world *jello)
 }
 
 /**
- * computeAcceleration - Computes acceleration to every control
- *                       point of the jello cube, which is in
- *                       state given by 'jello'
- *
- * @return - Returns result in array 'a'.
+ * accumulateAcceleration - Computes the acceleration of every control
+ *                          point, with or without the Collision Springs
+ *                          of the Bounding Box
  */
-void computeAcceleration(struct world *jello, struct point a[8][8][8])
+static void accumulateAcceleration(struct world *jello, struct point a[8][8][8], bool walls)
 {
-    // Get the Mass of the Mass Point
-    double m = jello->mass;
+    // Get the Inverse Mass of the Mass Point
+    double invMass = jello->invMass;
+
+    // Initialize Self-Collision Forces
+    point selfForce[8][8][8];
+    memset(selfForce, 0, sizeof(selfForce));
+
+    // Check if Self-Collision is Enabled
+    if (selfCollision == 1)
+    {
+        // Process Contacts between the Surface Vertices and Triangles
+        computeSelfCollision(jello, selfForce);
+    }
 
     // Iterate over X Dimension of Mass Points
     for (int i=0; i<=7; i++)
@@ -901,7 +919,7 @@ void computeAcceleration(struct world *jello, struct point a[8][8][8])
                 totalForce.z = 0.0;
 
                 // Check if there is a Collision
-                if(checkCollision(i,j,k, jello))
+                if(walls && checkCollision(i,j,k, jello))
                 {
                     // Process Collision Force
                     point collisionForce = processCollision(i,j,k,jello);
@@ -923,6 +941,13 @@ void computeAcceleration(struct world *jello, struct point a[8][8][8])
                 pSUM(totalForce, shearForce, totalForce);
                 pSUM(totalForce, bendForce, totalForce);
                 pSUM(totalForce, extForce, totalForce);
+                pSUM(totalForce, selfForce[i][j][k], totalForce);
+
+                // Add Contact Forces from other Bodies
+                if (jello->inContact)
+                {
+                    pSUM(totalForce, jello->contactForce[i][j][k], totalForce);
+                }
 
                 // Initialize the Acceleration
                 point acceleration;
@@ -931,13 +956,25 @@ void computeAcceleration(struct world *jello, struct point a[8][8][8])
                 acceleration.z = 0.0;
 
                 // Get the Acceleration
-                pMULTIPLY(totalForce, (1/m), acceleration);
+                pMULTIPLY(totalForce, invMass, acceleration);
                 a[i][j][k] = acceleration;
             }
         }
     }
 }
 
+/**
+ * computeAcceleration - Computes acceleration to every control
+ *                       point of the jello cube, which is in
+ *                       state given by 'jello'
+ *
+ * @return - Returns result in array 'a'.
+ */
+void computeAcceleration(struct world *jello, struct point a[8][8][8])
+{
+    accumulateAcceleration(jello, a, true);
+}
+
 /**
  * Euler - Performs one step of Euler Integration
  *         as a result, updates the jello structure
@@ -1105,3 +1142,236 @@ void RK4(struct world *jello)
 
     return;
 }
+
+/**
+ * multirateSubsteps - Number of Substeps the Collision Springs
+ *                     need per Timestep, from how much stiffer
+ *                     they are than the Internal Springs
+ */
+static int multirateSubsteps(struct world *jello)
+{
+    // The Stable Timestep scales with 1/sqrt(k)
+    if (jello->kElastic <= 0.0)
+    {
+        return MULTIRATE_MAX_SUBSTEPS;
+    }
+
+    int substeps = (int)ceil(sqrt(jello->kCollision / jello->kElastic));
+
+    return std::max(1, std::min(substeps, MULTIRATE_MAX_SUBSTEPS));
+}
+
+/**
+ * Multirate - Performs one step of Multi-Rate (RESPA) Integration:
+ *             the Internal Springs, Force Field and Contacts kick the
+ *             velocities at the outer timestep, while the Mass Points
+ *             near the Bounding Box are substepped with only their
+ *             Collision Springs. As a result, updates the jello structure
+ */
+void Multirate(struct world *jello)
+{
+    // Create iterators
+    int i,j,k;
+
+    // Get the Substeps of the Collision Springs
+    int substeps = multirateSubsteps(jello);
+    double h = jello->dt / substeps;
+    double invMass = jello->invMass;
+
+    // Compute the Slow Accelerations at the Current Positions (once, they are kept between steps)
+    if (!jello->slowValid)
+    {
+        accumulateAcceleration(jello, jello->slowAcceleration, false);
+        jello->slowValid = 1;
+    }
+
+    // Iterate over X Dimension of Mass Points
+    for (i=0; i<=7; i++)
+    {
+        // Iterate over Y Dimension of Mass Points
+        for (j=0; j<=7; j++)
+        {
+            // Iterate over Z Dimension of Mass Points
+            for (k=0; k<=7; k++)
+            {
+                // Half Kick with the Slow Forces
+                point kick;
+                pMULTIPLY(jello->slowAcceleration[i][j][k], 0.5 * jello->dt, kick);
+                pSUM(jello->v[i][j][k], kick, jello->v[i][j][k]);
+
+                // Check if the Mass Point is in or reaches Contact this Step
+                point end;
+                pMULTIPLY(jello->v[i][j][k], jello->dt, end);
+                pSUM(jello->p[i][j][k], end, end);
+
+                if (!checkCollision(i,j,k,jello) &&
+                    (end.x > -2.0) && (end.x < 2.0) &&
+                    (end.y > -2.0) && (end.y < 2.0) &&
+                    (end.z > -2.0) && (end.z < 2.0))
+                {
+                    // Free Mass Points just Drift
+                    jello->p[i][j][k] = end;
+                    continue;
+                }
+
+                // Substep the Collision Springs (Velocity Verlet)
+                point fast = processCollision(i,j,k,jello);
+                pMULTIPLY(fast, invMass, fast);
+
+                for (int s=0; s<substeps; s++)
+                {
+                    pMULTIPLY(fast, 0.5 * h, kick);
+                    pSUM(jello->v[i][j][k], kick, jello->v[i][j][k]);
+
+                    point drift;
+                    pMULTIPLY(jello->v[i][j][k], h, drift);
+                    pSUM(jello->p[i][j][k], drift, jello->p[i][j][k]);
+
+                    fast = processCollision(i,j,k,jello);
+                    pMULTIPLY(fast, invMass, fast);
+
+                    pMULTIPLY(fast, 0.5 * h, kick);
+                    pSUM(jello->v[i][j][k], kick, jello->v[i][j][k]);
+                }
+            }
+        }
+    }
+
+    // Compute the Slow Accelerations at the New Positions
+    accumulateAcceleration(jello, jello->slowAcceleration, false);
+
+    // Iterate over X Dimension of Mass Points
+    for (i=0; i<=7; i++)
+    {
+        // Iterate over Y Dimension of Mass Points
+        for (j=0; j<=7; j++)
+        {
+            // Iterate over Z Dimension of Mass Points
+            for (k=0; k<=7; k++)
+            {
+                // Closing Half Kick with the Slow Forces
+                point kick;
+                pMULTIPLY(jello->slowAcceleration[i][j][k], 0.5 * jello->dt, kick);
+                pSUM(jello->v[i][j][k], kick, jello->v[i][j][k]);
+            }
+        }
+    }
+}
+
+/**
+ * sweepAxis - Stops the Motion of a Mass Point from 'start' to 'end'
+ *             along one Axis at the Walls of the Bounding Box
+ *
+ * @return - Returns true if the Point went too deep into a Wall
+ */
+static bool sweepAxis(double start, double & end, double & v)
+{
+    // Check both Walls of the Axis (normal points into the box)
+    for (int side=-1; side<=1; side+=2)
+    {
+        double wall = side * BOX_SIZE;
+        double depth = side * (end - wall);
+
+        // Shallow Penetrations are left to the Collision Springs
+        if (depth <= CCD_THICKNESS)
+        {
+            continue;
+        }
+
+        if (side * (start - wall) < 0.0)
+        {
+            // Time of Impact along the Step. The walls are axis-aligned, so stopping there
+            // and sliding for the Rest of the Step only clamps the Coordinate along the Normal
+            double toi = (wall - start) / (end - start);
+            end = start + toi * (end - start);
+        }
+        else
+        {
+            // It started the Step in the Wall (continuous collision turned on mid-run, or
+            // a deep hit): clamp it to the Wall rather than holding it where it started,
+            // so the collision spring does not build up while it is stuck
+            end = wall;
+        }
+
+        // Remove the Velocity into the Wall
+        if (side * v > 0.0)
+        {
+            v = 0.0;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * sweepBoundingBox - Continuous Collision of the Steps of all
+ *                    the Mass Points against the Bounding Box
+ */
+int sweepBoundingBox(struct world *jello, struct point start[8][8][8])
+{
+    // Number of Points Stopped at a Wall
+    int clamped = 0;
+
+    // Iterate over X Dimension of Mass Points
+    for (int i=0; i<=7; i++)
+    {
+        // Iterate over Y Dimension of Mass Points
+        for (int j=0; j<=7; j++)
+        {
+            // Iterate over Z Dimension of Mass Points
+            for (int k=0; k<=7; k++)
+            {
+                point & p = jello->p[i][j][k];
+                point & v = jello->v[i][j][k];
+
+                // Sweep every Axis against its two Walls
+                bool hitX = sweepAxis(start[i][j][k].x, p.x, v.x);
+                bool hitY = sweepAxis(start[i][j][k].y, p.y, v.y);
+                bool hitZ = sweepAxis(start[i][j][k].z, p.z, v.z);
+
+                if (hitX || hitY || hitZ)
+                {
+                    clamped++;
+                }
+            }
+        }
+    }
+
+    return clamped;
+}
+
+/**
+ * integrate - Performs one step of the Integrator
+ *             named in the World File
+ */
+void integrate(struct world *jello)
+{
+    // Get Integrator
+    std::string integrator = std::string(jello->integrator);
+
+    // Initialize Integrator Strings
+    std::string rk4 = "RK4";
+    std::string euler = "EULER";
+    std::string multirate = "MULTIRATE";
+
+    // Check if Integrator is Euler
+    if(integrator.compare(euler) == 0)
+    {
+        // Peform Euler Integration
+        Euler(jello);
+    }
+    // Check if Integrator is RK4
+    else if(integrator.compare(rk4) == 0)
+    {
+        // Perform Runge-Katta 4 Integration
+        RK4(jello);
+    }
+    // Check if Integrator is Multi-Rate
+    else if(integrator.compare(multirate) == 0)
+    {
+        // Perform Multi-Rate Integration
+        Multirate(jello);
+    }
+}
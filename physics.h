@@ -15,5 +15,19 @@ void computeAcceleration(struct world * jello, struct point a[8][8][8]);
 void Euler(struct world * jello);
 void RK4(struct world * jello);
 
+// perform one step of multi-rate integration: the internal springs, force field
+// and contacts advance at dt, points near the walls are substepped with their
+// collision springs only
+void Multirate(struct world * jello);
+
+// continuous collision against the bounding box: stops every point whose step
+// from 'start' to its current position went deeper than the contact thickness
+// into a wall at the wall, and removes its velocity into the wall
+// returns the number of points stopped
+int sweepBoundingBox(struct world * jello, struct point start[8][8][8]);
+
+// performs one step of the integrator named in the world file ("Euler", "RK4" or "MULTIRATE")
+void integrate(struct world * jello);
+
 #endif
 
@@ -81,9 +81,12 @@ Pic_file_format pic_filename_type(char *file)
   char *suff;
 
   suff = strrchr(file, '.');
+  if (!suff) return PIC_UNKNOWN_FILE;
   if (!strcmp(suff, ".jpg")) return PIC_JPEG_FILE;
   if (!strcmp(suff, ".tiff") || !strcmp(suff, ".tif")) return PIC_TIFF_FILE;
   if (!strcmp(suff, ".ppm")) return PIC_PPM_FILE;
+  if (!strcmp(suff, ".png")) return PIC_PNG_FILE;
+  if (!strcmp(suff, ".qoi")) return PIC_QOI_FILE;
   return PIC_UNKNOWN_FILE;
 }
 
@@ -155,6 +158,14 @@ int pic_write(char *file, Pic *pic, Pic_file_format format)
     case PIC_JPEG_FILE:
      //return jpeg_write(file, pic);
     break;
+
+    case PIC_PNG_FILE:
+      return png_write(file, pic);
+    break;
+
+    case PIC_QOI_FILE:
+      return qoi_write(file, pic);
+    break;
 			
     default:
       fprintf(stderr, "pic_write: can't write %s, unknown format\n", file);
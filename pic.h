@@ -48,7 +48,7 @@ typedef struct {		/* PICTURE */
     /* returns channel chan of pixel (x,y) of picture pic */
     /* usually chan=0 for red, 1 for green, 2 for blue */
 
-typedef enum {PIC_TIFF_FILE, PIC_PPM_FILE, PIC_JPEG_FILE, PIC_UNKNOWN_FILE} Pic_file_format; // only PPM is supported 
+typedef enum {PIC_TIFF_FILE, PIC_PPM_FILE, PIC_JPEG_FILE, PIC_PNG_FILE, PIC_QOI_FILE, PIC_UNKNOWN_FILE} Pic_file_format; // PPM is read, PPM, PNG and QOI are written
 
 /*----------------------Allocation routines--------------------------*/
 extern Pic *pic_alloc(int nx, int ny, int bytes_per_pixel, Pic *opic);
@@ -69,12 +69,34 @@ extern int ppm_get_size(char *file, int *nx, int *ny);
 extern Pic *ppm_read(char *file, Pic *opic);
 extern int ppm_write(char *file, Pic *pic);
 
+/*
+ * read-only views of binary PPM files mapped into memory: pix points into
+ * the mapping, nothing is copied. Release them with ppm_unmap, not pic_free.
+ */
+extern Pic *ppm_map(char *file);
+extern void ppm_unmap(Pic *p);
+
+/*
+ * maps a list of files in order, keeping the next 'ahead' files mapped and
+ * read ahead by the kernel (madvise). ppm_batch_next returns the next file
+ * (NULL past the end, or if it can't be read), owned by the caller.
+ */
+typedef struct Ppm_batch Ppm_batch;
+extern Ppm_batch *ppm_batch_open(char **files, int count, int ahead);
+extern Pic *ppm_batch_next(Ppm_batch *batch);
+extern void ppm_batch_close(Ppm_batch *batch);
+
+/* lossless, written from 3 byte per pixel Pics only */
+extern int png_write(char *file, Pic *pic);
+extern int qoi_write(char *file, Pic *pic);
+
+extern int pic_write(char *file, Pic *pic, Pic_file_format format);
+extern Pic_file_format pic_filename_type(char *file);
+
 /*
 extern int pic_get_size(char *file, int *nx, int *ny);
 extern Pic *pic_read(char *file, Pic *opic);
-extern int pic_write(char *file, Pic *pic, Pic_file_format format);
 extern Pic_file_format pic_file_type(char *file);
-extern Pic_file_format pic_filename_type(char *file);
 */
 
 #ifdef __cplusplus
@@ -0,0 +1,413 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "pic.h"
+#include "threadPool.h"
+
+// Rows per Stripe, every Stripe is Filtered and Compressed on its own
+// and Stored as one IDAT Chunk
+const int PNG_STRIPE = 32;
+
+// Deflate Length Codes 257 - 285: Shortest Length and Extra Bits
+static const unsigned short lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+// Tables Built on First Use
+struct pngTables
+{
+    unsigned int crc[256];          // CRC-32 of every byte
+    unsigned short code[288];       // fixed Huffman codes, bit-reversed for LSB first output
+    unsigned char codeLength[288];
+    unsigned char lengthCode[259];  // length code - 257 of every match length
+
+    pngTables()
+    {
+        for (unsigned int n=0; n<256; n++)
+        {
+            unsigned int c = n;
+            for (int k=0; k<8; k++)
+            {
+                c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+            }
+            crc[n] = c;
+        }
+
+        for (int symbol=0; symbol<288; symbol++)
+        {
+            unsigned int value;
+            int length;
+
+            if (symbol < 144)
+            {
+                value = 0x30 + symbol;
+                length = 8;
+            }
+            else if (symbol < 256)
+            {
+                value = 0x190 + (symbol - 144);
+                length = 9;
+            }
+            else if (symbol < 280)
+            {
+                value = symbol - 256;
+                length = 7;
+            }
+            else
+            {
+                value = 0xc0 + (symbol - 280);
+                length = 8;
+            }
+
+            unsigned int reversed = 0;
+            for (int k=0; k<length; k++)
+            {
+                reversed |= ((value >> k) & 1) << (length - 1 - k);
+            }
+            code[symbol] = reversed;
+            codeLength[symbol] = length;
+        }
+
+        for (int c=0; c<29; c++)
+        {
+            int last = (c < 28) ? lengthBase[c + 1] : 259;
+            for (int length=lengthBase[c]; length<last; length++)
+            {
+                lengthCode[length] = c;
+            }
+        }
+    }
+};
+
+static const pngTables & tables()
+{
+    static const pngTables built;
+    return built;
+}
+
+// Appends Bits Least Significant First, the Way Deflate Packs them
+struct bitWriter
+{
+    std::vector<unsigned char> & out;
+    unsigned long long bits;
+    int count;
+
+    bitWriter(std::vector<unsigned char> & out) : out(out), bits(0), count(0) {}
+
+    void put(unsigned int value, int length)
+    {
+        bits |= (unsigned long long) value << count;
+        count += length;
+        while (count >= 8)
+        {
+            out.push_back(bits & 0xff);
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    // pads to a whole byte
+    void align()
+    {
+        if (count > 0)
+        {
+            put(0, 8 - count);
+        }
+    }
+};
+
+/**
+ * updateCrc - Continues a CRC-32 over size Bytes
+ */
+static unsigned int updateCrc(unsigned int crc, const unsigned char * data, size_t size)
+{
+    const pngTables & t = tables();
+    crc = ~crc;
+    for (size_t i=0; i<size; i++)
+    {
+        crc = t.crc[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * putBigEndian - Appends a 32-bit Value Most Significant Byte First
+ */
+static void putBigEndian(std::vector<unsigned char> & out, unsigned int value)
+{
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+/**
+ * paethRow - Paeth Filters a Row against the Row above it (the
+ *            Predictor is picked without Branches, so it Vectorizes)
+ */
+static void paethRow(const Pixel1 * row, const Pixel1 * above, unsigned char * out, int stride)
+{
+    // The First Pixel has no Left Neighbours
+    for (int i=0; i<3; i++)
+    {
+        out[i] = row[i] - above[i];
+    }
+
+    for (int i=3; i<stride; i++)
+    {
+        int left = row[i - 3];
+        int up = above[i];
+        int upLeft = above[i - 3];
+
+        int pLeft = abs(up - upLeft);
+        int pUp = abs(left - upLeft);
+        int pUpLeft = abs(left + up - 2 * upLeft);
+
+        int predictor = ((pLeft <= pUp) && (pLeft <= pUpLeft)) ? left : ((pUp <= pUpLeft) ? up : upLeft);
+        out[i] = row[i] - predictor;
+    }
+}
+
+/**
+ * filterRows - Paeth Filters the Rows [begin, end) of pic into
+ *              filtered, a Filter Type Byte in Front of every Row
+ */
+static void filterRows(Pic * pic, int begin, int end, std::vector<unsigned char> & filtered)
+{
+    int stride = 3 * pic->nx;
+    filtered.resize((end - begin) * (stride + 1));
+    unsigned char * out = &filtered[0];
+
+    // The Top Row is Filtered against a Row of Zeros
+    std::vector<Pixel1> zeros(stride, 0);
+
+    for (int y=begin; y<end; y++)
+    {
+        const Pixel1 * row = &pic->pix[y * stride];
+        const Pixel1 * above = (y > 0) ? row - stride : &zeros[0];
+
+        *out++ = 4; // Paeth
+        paethRow(row, above, out, stride);
+        out += stride;
+    }
+}
+
+/**
+ * deflateStripe - Compresses a Stripe into one Fixed Huffman Block,
+ *                 Runs of a Byte as Matches at Distance 1. Every Stripe
+ *                 but the Last ends Byte Aligned with an Empty Stored
+ *                 Block, so the Stripes can be Concatenated.
+ */
+static void deflateStripe(const std::vector<unsigned char> & data, bool last, std::vector<unsigned char> & out)
+{
+    const pngTables & t = tables();
+    bitWriter bits(out);
+    size_t size = data.size();
+
+    bits.put(last ? 1 : 0, 1); // BFINAL
+    bits.put(1, 2);            // fixed Huffman codes
+
+    size_t i = 0;
+    while (i < size)
+    {
+        // The Byte itself, then its Repeats
+        unsigned char value = data[i];
+        bits.put(t.code[value], t.codeLength[value]);
+        i++;
+
+        size_t repeats = 0;
+        while ((i + repeats < size) && (data[i + repeats] == value))
+        {
+            repeats++;
+        }
+
+        while (repeats >= 3)
+        {
+            int length = (repeats < 258) ? (int) repeats : 258;
+
+            // Leave a Remainder that is still a Valid Match
+            if ((repeats - length > 0) && (repeats - length < 3))
+            {
+                length -= 3;
+            }
+
+            int c = t.lengthCode[length];
+            bits.put(t.code[257 + c], t.codeLength[257 + c]);
+            bits.put(length - lengthBase[c], lengthExtra[c]);
+            bits.put(0, 5); // distance code 0: distance 1
+
+            i += length;
+            repeats -= length;
+        }
+
+        for (; repeats > 0; repeats--)
+        {
+            bits.put(t.code[value], t.codeLength[value]);
+            i++;
+        }
+    }
+
+    bits.put(t.code[256], t.codeLength[256]); // end of block
+
+    if (!last)
+    {
+        bits.put(0, 3); // empty stored block
+        bits.align();
+        static const unsigned char empty[4] = { 0x00, 0x00, 0xff, 0xff };
+        out.insert(out.end(), empty, empty + 4);
+    }
+
+    bits.align();
+}
+
+/**
+ * adler32 - Adler-32 Checksum of the Zlib Stream, (b << 16) | a
+ */
+static unsigned int adler32(const unsigned char * data, size_t size)
+{
+    unsigned int a = 1, b = 0;
+    while (size > 0)
+    {
+        // Largest Block without Overflow before the Modulo
+        size_t block = (size < 5552) ? size : 5552;
+        for (size_t i=0; i<block; i++)
+        {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += block;
+        size -= block;
+    }
+    return (b << 16) | a;
+}
+
+/**
+ * combineAdler32 - Checksum of two Streams back to back,
+ *                  from their own Checksums
+ */
+static unsigned int combineAdler32(unsigned int first, unsigned int second, size_t secondSize)
+{
+    const unsigned int BASE = 65521;
+    unsigned int rem = secondSize % BASE;
+    unsigned int a = first & 0xffff;
+    unsigned int b = (unsigned int) (((unsigned long long) rem * a) % BASE);
+
+    a += (second & 0xffff) + BASE - 1;
+    b += ((first >> 16) & 0xffff) + ((second >> 16) & 0xffff) + BASE - rem;
+
+    if (a >= BASE) a -= BASE;
+    if (a >= BASE) a -= BASE;
+    if (b >= 2 * BASE) b -= 2 * BASE;
+    if (b >= BASE) b -= BASE;
+
+    return (b << 16) | a;
+}
+
+/**
+ * writeChunk - Appends a PNG Chunk around data
+ */
+static void writeChunk(std::vector<unsigned char> & out, const char * type, const unsigned char * data, size_t size)
+{
+    putBigEndian(out, size);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    putBigEndian(out, updateCrc(0, &out[start], out.size() - start));
+}
+
+/**
+ * png_write - Writes pic (3 bytes per pixel) to file as a PNG. The Stripes
+ *             of PNG_STRIPE Rows are Filtered and Compressed in Parallel.
+ */
+int png_write(char *file, Pic *pic)
+{
+    if (pic->bpp != 3)
+    {
+        fprintf(stderr, "png_write: can't write %d byte per pixel Pic\n", pic->bpp);
+        return FALSE;
+    }
+
+    int stripes = (pic->ny + PNG_STRIPE - 1) / PNG_STRIPE;
+    std::vector<std::vector<unsigned char> > chunks(stripes);
+    std::vector<unsigned int> checksums(stripes);
+    std::vector<size_t> sizes(stripes);
+
+    // IDAT Chunk of every Stripe, the Zlib Header goes into the First one
+    parallelFor(stripes, 1, [&](int begin, int end)
+    {
+        std::vector<unsigned char> filtered;
+        for (int s=begin; s<end; s++)
+        {
+            int first = s * PNG_STRIPE;
+            int last = (first + PNG_STRIPE < pic->ny) ? (first + PNG_STRIPE) : pic->ny;
+            filterRows(pic, first, last, filtered);
+            checksums[s] = adler32(&filtered[0], filtered.size());
+            sizes[s] = filtered.size();
+
+            std::vector<unsigned char> & chunk = chunks[s];
+            chunk.clear();
+            if (s == 0)
+            {
+                chunk.push_back(0x78); // deflate, 32K window
+                chunk.push_back(0x01); // no preset dictionary, fastest
+            }
+            deflateStripe(filtered, s == stripes - 1, chunk);
+        }
+    });
+
+    // The Adler-32 of the whole Stream ends the Last Chunk
+    unsigned int checksum = checksums[0];
+    for (int s=1; s<stripes; s++)
+    {
+        checksum = combineAdler32(checksum, checksums[s], sizes[s]);
+    }
+    putBigEndian(chunks[stripes - 1], checksum);
+
+    // Signature, Header, Data, End
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<unsigned char> out(signature, signature + 8);
+
+    std::vector<unsigned char> header;
+    putBigEndian(header, pic->nx);
+    putBigEndian(header, pic->ny);
+    header.push_back(8); // bits per channel
+    header.push_back(2); // RGB
+    header.push_back(0); // deflate
+    header.push_back(0); // adaptive filtering
+    header.push_back(0); // not interlaced
+    writeChunk(out, "IHDR", &header[0], header.size());
+
+    for (int s=0; s<stripes; s++)
+    {
+        writeChunk(out, "IDAT", &chunks[s][0], chunks[s].size());
+    }
+    writeChunk(out, "IEND", NULL, 0);
+
+    FILE *png = fopen(file, "wb");
+    if (!png)
+    {
+        return FALSE;
+    }
+
+    if (fwrite(&out[0], 1, out.size(), png) != out.size())
+    {
+        fprintf(stderr, "png_write: error writing %s\n", file);
+        fclose(png);
+        return FALSE;
+    }
+
+    fclose(png);
+    return TRUE;
+}
@@ -0,0 +1,434 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "surfaceMesh.h"
+#include "pointCache.h"
+#include "frameWriter.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// glTF Constants
+const int GLTF_MAX_FRAMES = 65535; // the weights of the animation are indexed with 32 bits (frames^2)
+const int GLTF_UNSIGNED_INT = 5125;
+const int GLTF_FLOAT = 5126;
+const int GLTF_ARRAY_BUFFER = 34962;
+const int GLTF_ELEMENT_ARRAY_BUFFER = 34963;
+
+// Surface Vertices of every Body, Waiting for the Writer
+struct exportedFrame
+{
+    std::vector<float> p; // x y z of every surface vertex, in body order
+};
+
+// Exporter State (never freed, see frameWriter.h)
+struct pointCacheExporter
+{
+    frameWriter<struct exportedFrame> writer;
+
+    std::string name;
+    int bodies;
+    int vertices;                   // surface vertices of all the bodies
+    double frameTime;               // simulated time between two frames
+    bool gltf;
+
+    writtenFile obj;
+    writtenFile pc2;
+    writtenFile gltfFile;
+    writtenFile bin;                // its bytes are the offset of the next glTF buffer view
+    FILE * accessors;               // accessors of the morph targets, until the glTF is written
+
+    // Writer State
+    long samples;                   // frames written to the point cache
+    long targets;                   // frames written to the glTF
+    std::vector<float> base;        // first frame, the morph targets are relative to it
+    std::vector<float> displacement;
+    float baseMin[3], baseMax[3];
+
+    pointCacheExporter() : writer(EXPORT_BUFFERS), accessors(NULL), samples(0), targets(0) {}
+};
+
+static struct pointCacheExporter * exporter = NULL;
+
+/**
+ * gatherBody - Copies the Surface Vertices of a Body
+ *              out of its 512 Mass Points
+ */
+static void gatherBody(const struct point * p, float * out)
+{
+    for (int s=0; s<SURFACE_VERTICES; s++)
+    {
+        const struct point & vertex = p[64 * surface.vertex[s][0] + 8 * surface.vertex[s][1] + surface.vertex[s][2]];
+
+        out[3*s] = (float) vertex.x;
+        out[3*s+1] = (float) vertex.y;
+        out[3*s+2] = (float) vertex.z;
+    }
+}
+
+/**
+ * writeMesh - Writes the Surface Mesh once, with the
+ *             Positions of the First Frame
+ */
+static void writeMesh(const std::vector<float> & p)
+{
+    // Wavefront OBJ, one Object so the Vertices keep the Order of the Point Cache
+    fprintf(exporter->obj.file, "# jello surface, %d vertices in the order of %s.pc2\n", exporter->vertices, exporter->name.c_str());
+    fprintf(exporter->obj.file, "o jello\n");
+
+    for (int v=0; v<exporter->vertices; v++)
+    {
+        fprintf(exporter->obj.file, "v %.9g %.9g %.9g\n", p[3*v], p[3*v+1], p[3*v+2]);
+    }
+
+    for (int b=0; b<exporter->bodies; b++)
+    {
+        for (int t=0; t<SURFACE_TRIANGLES; t++)
+        {
+            fprintf(exporter->obj.file, "f %d %d %d\n", b * SURFACE_VERTICES + surface.triangle[t][0] + 1,
+                    b * SURFACE_VERTICES + surface.triangle[t][1] + 1, b * SURFACE_VERTICES + surface.triangle[t][2] + 1);
+        }
+    }
+
+    if (!exporter->gltf)
+    {
+        return;
+    }
+
+    // Base Positions of the glTF, after the Indices
+    exporter->base = p;
+    for (int c=0; c<3; c++)
+    {
+        exporter->baseMin[c] = exporter->baseMax[c] = p[c];
+    }
+    for (int v=1; v<exporter->vertices; v++)
+    {
+        for (int c=0; c<3; c++)
+        {
+            exporter->baseMin[c] = std::min(exporter->baseMin[c], p[3*v+c]);
+            exporter->baseMax[c] = std::max(exporter->baseMax[c], p[3*v+c]);
+        }
+    }
+
+    exporter->bin.write(p.data(), p.size() * sizeof(float));
+}
+
+/**
+ * writeTarget - Appends a Frame to the glTF Buffer as the
+ *               Displacement of the Vertices from the Base
+ */
+static void writeTarget(const std::vector<float> & p)
+{
+    std::vector<float> & displacement = exporter->displacement;
+    displacement.resize(p.size());
+
+    float lo[3], hi[3];
+    for (int c=0; c<3; c++)
+    {
+        lo[c] = hi[c] = p[c] - exporter->base[c];
+    }
+
+    for (size_t i=0; i<p.size(); i++)
+    {
+        int c = i % 3;
+        displacement[i] = p[i] - exporter->base[i];
+        lo[c] = std::min(lo[c], displacement[i]);
+        hi[c] = std::max(hi[c], displacement[i]);
+    }
+
+    // Offset in the Buffer View of the Positions, which starts with the Base
+    int64_t frameBytes = displacement.size() * sizeof(float);
+    fprintf(exporter->accessors, ",\n    {\"bufferView\":1,\"byteOffset\":%lld,\"componentType\":%d,\"count\":%d,\"type\":\"VEC3\","
+            "\"min\":[%.9g,%.9g,%.9g],\"max\":[%.9g,%.9g,%.9g]}",
+            (long long) ((exporter->targets + 1) * frameBytes), GLTF_FLOAT, exporter->vertices,
+            lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+
+    exporter->bin.write(displacement.data(), frameBytes);
+    exporter->targets++;
+}
+
+/**
+ * writeFrame - Appends a Queued Frame to the Files
+ *              (on the Writer Thread)
+ */
+static void writeFrame(struct exportedFrame * frame)
+{
+    if (exporter->samples == 0)
+    {
+        writeMesh(frame->p);
+    }
+
+    exporter->pc2.write(frame->p.data(), frame->p.size() * sizeof(float));
+    exporter->samples++;
+
+    if (exporter->gltf && (exporter->targets < GLTF_MAX_FRAMES))
+    {
+        writeTarget(frame->p);
+
+        if (exporter->targets == GLTF_MAX_FRAMES)
+        {
+            printf("The glTF export holds at most %d frames, the rest only goes into %s.pc2\n",
+                   GLTF_MAX_FRAMES, exporter->name.c_str());
+        }
+    }
+}
+
+/**
+ * startExport - Writes the Headers and Starts the Writer Thread
+ */
+int startExport(const char * name, int bodies, double frameTime, int gltf)
+{
+    if (exporter != NULL)
+    {
+        return 1;
+    }
+
+    exporter = new pointCacheExporter();
+    exporter->name = name;
+    exporter->bodies = bodies;
+    exporter->vertices = bodies * SURFACE_VERTICES;
+    exporter->frameTime = frameTime;
+    exporter->gltf = (gltf != 0);
+
+    bool opened = exporter->obj.open(exporter->name + ".obj", "w");
+    opened = exporter->pc2.open(exporter->name + ".pc2", "wb") && opened;
+    if (exporter->gltf)
+    {
+        opened = exporter->gltfFile.open(exporter->name + ".gltf", "w") && opened;
+        opened = exporter->bin.open(exporter->name + ".bin", "wb") && opened;
+        exporter->accessors = tmpfile();
+    }
+
+    if (!opened || (exporter->gltf && (exporter->accessors == NULL)))
+    {
+        return 0;
+    }
+
+    // Point Cache Header, the Samples are Filled in at the End
+    int32_t version = 1;
+    int32_t vertices = exporter->vertices;
+    float startFrame = 0.0f;
+    float sampleRate = 1.0f;
+    int32_t samples = 0;
+    exporter->pc2.write("POINTCACHE2\0", 12);
+    exporter->pc2.write(&version, sizeof(version));
+    exporter->pc2.write(&vertices, sizeof(vertices));
+    exporter->pc2.write(&startFrame, sizeof(startFrame));
+    exporter->pc2.write(&sampleRate, sizeof(sampleRate));
+    exporter->pc2.write(&samples, sizeof(samples));
+
+    // Triangles of the glTF, first in its Buffer
+    if (exporter->gltf)
+    {
+        for (int b=0; b<bodies; b++)
+        {
+            for (int t=0; t<SURFACE_TRIANGLES; t++)
+            {
+                uint32_t triangle[3];
+                for (int c=0; c<3; c++)
+                {
+                    triangle[c] = b * SURFACE_VERTICES + surface.triangle[t][c];
+                }
+                exporter->bin.write(triangle, sizeof(triangle));
+            }
+        }
+    }
+
+    // Frames Reused by the Exporting Thread
+    for (int i=0; i<EXPORT_BUFFERS; i++)
+    {
+        struct exportedFrame * frame = new exportedFrame();
+        frame->p.resize(3 * exporter->vertices);
+        exporter->writer.addFrame(frame);
+    }
+
+    exporter->writer.start(1, writeFrame);
+    atexit(stopExport);
+
+    printf("Exporting the surface to %s.obj and %s.pc2%s, %g frames per second of simulated time\n",
+           name, name, exporter->gltf ? " (and glTF)" : "", 1.0 / frameTime);
+
+    return 1;
+}
+
+/**
+ * exporting - Checks if an Export was Started
+ */
+int exporting()
+{
+    return (exporter != NULL) && !exporter->writer.stopped;
+}
+
+/**
+ * exportFrame - Queues the Surface Vertices of the Positions
+ */
+void exportFrame(const std::vector<struct point> & positions)
+{
+    struct exportedFrame * frame;
+    if (!exporting() || (positions.size() < 512 * (size_t) exporter->bodies) || ((frame = exporter->writer.acquire()) == NULL))
+    {
+        return;
+    }
+
+    for (int b=0; b<exporter->bodies; b++)
+    {
+        gatherBody(&positions[512 * b], &frame->p[3 * SURFACE_VERTICES * b]);
+    }
+
+    exporter->writer.submit(frame);
+}
+
+/**
+ * exportScene - Queues the Surface Vertices of the Scene
+ */
+void exportScene(struct scene * scene)
+{
+    struct exportedFrame * frame;
+    if (!exporting() || ((int) scene->bodies.size() != exporter->bodies) || ((frame = exporter->writer.acquire()) == NULL))
+    {
+        return;
+    }
+
+    for (int b=0; b<exporter->bodies; b++)
+    {
+        gatherBody(&scene->bodies[b]->p[0][0][0], &frame->p[3 * SURFACE_VERTICES * b]);
+    }
+
+    exporter->writer.submit(frame);
+}
+
+/**
+ * writeGltf - Writes the Animation Times and Weights to the Buffer,
+ *             and the glTF referring to it
+ */
+static void writeGltf()
+{
+    long frames = exporter->targets;
+    FILE * file = exporter->gltfFile.file;
+
+    // Time of every Frame
+    int64_t timesOffset = exporter->bin.bytes;
+    for (long f=0; f<frames; f++)
+    {
+        float time = (float) (f * exporter->frameTime);
+        exporter->bin.write(&time, sizeof(time));
+    }
+
+    // Weights: Frame f shows Target f only, stored as the Ones of a Sparse frames x frames Matrix
+    int64_t indicesOffset = timesOffset + frames * sizeof(float);
+    for (long f=0; f<frames; f++)
+    {
+        uint32_t index = (uint32_t) (f * (frames + 1));
+        exporter->bin.write(&index, sizeof(index));
+    }
+
+    int64_t valuesOffset = indicesOffset + frames * sizeof(uint32_t);
+    for (long f=0; f<frames; f++)
+    {
+        float one = 1.0f;
+        exporter->bin.write(&one, sizeof(one));
+    }
+    int64_t bufferBytes = valuesOffset + frames * sizeof(float);
+
+    // The Buffer lies next to the glTF
+    std::string binName = exporter->name + ".bin";
+    size_t slash = binName.find_last_of('/');
+    std::string uri = (slash == std::string::npos) ? binName : binName.substr(slash + 1);
+
+    int64_t indexBytes = (int64_t) exporter->bodies * SURFACE_TRIANGLES * 3 * sizeof(uint32_t);
+    int64_t positionBytes = timesOffset - indexBytes;
+
+    fprintf(file, "{\n  \"asset\":{\"version\":\"2.0\",\"generator\":\"jello\"},\n");
+    fprintf(file, "  \"scene\":0,\n  \"scenes\":[{\"nodes\":[0]}],\n");
+    fprintf(file, "  \"nodes\":[{\"name\":\"jello\",\"mesh\":0}],\n");
+
+    // Mesh with one Morph Target per Frame (Accessors 4 ...)
+    fprintf(file, "  \"meshes\":[{\"name\":\"jello\",\"primitives\":[{\"attributes\":{\"POSITION\":1},\"indices\":0,\"targets\":[");
+    for (long f=0; f<frames; f++)
+    {
+        fprintf(file, "%s{\"POSITION\":%ld}", (f > 0) ? "," : "", 4 + f);
+    }
+    fprintf(file, "]}]}],\n");
+
+    fprintf(file, "  \"animations\":[{\"name\":\"simulation\",\"samplers\":[{\"input\":2,\"interpolation\":\"LINEAR\",\"output\":3}],"
+            "\"channels\":[{\"sampler\":0,\"target\":{\"node\":0,\"path\":\"weights\"}}]}],\n");
+
+    fprintf(file, "  \"buffers\":[{\"uri\":\"%s\",\"byteLength\":%lld}],\n", uri.c_str(), (long long) bufferBytes);
+    fprintf(file, "  \"bufferViews\":[\n");
+    fprintf(file, "    {\"buffer\":0,\"byteOffset\":0,\"byteLength\":%lld,\"target\":%d},\n", (long long) indexBytes, GLTF_ELEMENT_ARRAY_BUFFER);
+    fprintf(file, "    {\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%lld,\"target\":%d},\n",
+            (long long) indexBytes, (long long) positionBytes, GLTF_ARRAY_BUFFER);
+    fprintf(file, "    {\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%lld},\n", (long long) timesOffset, (long long) (frames * sizeof(float)));
+    fprintf(file, "    {\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%lld},\n", (long long) indicesOffset, (long long) (frames * sizeof(uint32_t)));
+    fprintf(file, "    {\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%lld}],\n", (long long) valuesOffset, (long long) (frames * sizeof(float)));
+
+    fprintf(file, "  \"accessors\":[\n");
+    fprintf(file, "    {\"bufferView\":0,\"componentType\":%d,\"count\":%d,\"type\":\"SCALAR\"},\n",
+            GLTF_UNSIGNED_INT, exporter->bodies * SURFACE_TRIANGLES * 3);
+    fprintf(file, "    {\"bufferView\":1,\"componentType\":%d,\"count\":%d,\"type\":\"VEC3\",\"min\":[%.9g,%.9g,%.9g],\"max\":[%.9g,%.9g,%.9g]},\n",
+            GLTF_FLOAT, exporter->vertices, exporter->baseMin[0], exporter->baseMin[1], exporter->baseMin[2],
+            exporter->baseMax[0], exporter->baseMax[1], exporter->baseMax[2]);
+    fprintf(file, "    {\"bufferView\":2,\"componentType\":%d,\"count\":%ld,\"type\":\"SCALAR\",\"min\":[0],\"max\":[%.9g]},\n",
+            GLTF_FLOAT, frames, (float) ((frames - 1) * exporter->frameTime));
+    fprintf(file, "    {\"componentType\":%d,\"count\":%lld,\"type\":\"SCALAR\",\"sparse\":{\"count\":%ld,"
+            "\"indices\":{\"bufferView\":3,\"componentType\":%d},\"values\":{\"bufferView\":4}}}",
+            GLTF_FLOAT, (long long) frames * frames, frames, GLTF_UNSIGNED_INT);
+
+    // Accessors of the Morph Targets, Kept Aside while the Frames were Streamed
+    char chunk[4096];
+    size_t size;
+    rewind(exporter->accessors);
+    while ((size = fread(chunk, 1, sizeof(chunk), exporter->accessors)) > 0)
+    {
+        exporter->gltfFile.write(chunk, size);
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+}
+
+/**
+ * stopExport - Writes the Queued Frames and Finishes the Files
+ */
+void stopExport()
+{
+    if (!exporting())
+    {
+        return;
+    }
+
+    // Drain the Queue
+    exporter->writer.stop();
+
+    // Number of Samples of the Point Cache
+    int32_t samples = exporter->samples;
+    fseek(exporter->pc2.file, 28, SEEK_SET);
+    exporter->pc2.write(&samples, sizeof(samples));
+    exporter->pc2.close();
+    exporter->obj.close();
+
+    if (exporter->gltf)
+    {
+        if (exporter->targets > 0)
+        {
+            writeGltf();
+        }
+        else
+        {
+            printf("No frames were exported to %s.gltf\n", exporter->name.c_str());
+        }
+
+        fclose(exporter->accessors);
+        exporter->bin.close();
+        exporter->gltfFile.close();
+    }
+
+    printf("Exported %ld frames to %s\n", exporter->samples, exporter->name.c_str());
+}
@@ -0,0 +1,46 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _POINTCACHE_H_
+#define _POINTCACHE_H_
+
+#include <vector>
+
+// Point Cache Export for Blender, Houdini, ...: the surface mesh of every jello
+// (SURFACE_VERTICES vertices, SURFACE_TRIANGLES triangles each, one object) is
+// written once as name.obj, and the positions of its vertices at every exported
+// frame are appended to name.pc2:
+//   "POINTCACHE2\0", version 1, vertices (int32), start frame 0, 1 sample per
+//   frame (floats), samples (int32, filled in when the export stops)
+//   then x y z (floats) of every vertex, in the order of the OBJ, for every sample
+// With glTF, name.gltf and name.bin hold the same mesh with one morph target per
+// frame, and an animation switching between them. The frames are streamed into
+// name.bin, and name.gltf is written when the export stops.
+
+// number of frames waiting for the writer thread
+#define EXPORT_BUFFERS 16
+
+// starts the thread exporting the surface of 'bodies' jellos to name.obj and name.pc2
+// (and name.gltf, name.bin if 'gltf'), 'frameTime' seconds of simulated time apart.
+// stopExport is registered with atexit. Returns 0 if the files can't be created.
+int startExport(const char * name, int bodies, double frameTime, int gltf);
+
+// checks if an export was started
+int exporting();
+
+// queues the surface vertices of 'positions' (512 mass points per body, in body
+// order) as the next frame, waiting while all the frames are queued
+void exportFrame(const std::vector<struct point> & positions);
+
+// queues the surface vertices of the bodies of the scene as the next frame
+void exportScene(struct scene * scene);
+
+// writes the queued frames, finishes the files and stops the writer thread
+void stopExport();
+
+#endif
+
@@ -0,0 +1,271 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pic.h"
+
+// Pic Viewing a Mapped File, the Pic comes First so
+// ppm_unmap can get back from it to the Mapping
+struct mappedPic
+{
+    Pic pic;
+    void * base;
+    size_t length;
+};
+
+// Files Mapped ahead of the one being Read
+struct Ppm_batch
+{
+    char ** files;
+    int count;
+    int ahead;              // files mapped and prefetched in advance
+    int next;               // next file handed out
+    int mapped;             // next file to map
+    struct mappedPic ** ring; // mapped files [next, mapped), at index % ahead
+};
+
+/**
+ * headerNumber - Parses a Number of the PPM Header, after Whitespace
+ *                and Comments. Returns NULL past the End of the Header.
+ */
+static const char * headerNumber(const char * at, const char * end, int * value)
+{
+    for (;;)
+    {
+        while ((at < end) && isspace((unsigned char) *at))
+        {
+            at++;
+        }
+        if ((at >= end) || (*at != '#'))
+        {
+            break;
+        }
+        while ((at < end) && (*at != '\n'))
+        {
+            at++;
+        }
+    }
+
+    if ((at >= end) || !isdigit((unsigned char) *at))
+    {
+        return NULL;
+    }
+
+    *value = 0;
+    while ((at < end) && isdigit((unsigned char) *at) && (*value < 1000000))
+    {
+        *value = *value * 10 + (*at - '0');
+        at++;
+    }
+    return at;
+}
+
+/**
+ * mapFile - Maps a binary PPM File and Parses its Header in Place
+ */
+static struct mappedPic * mapFile(char * file)
+{
+    int fd = open(file, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "can't read PPM file %s\n", file);
+        return NULL;
+    }
+
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || (status.st_size < 2))
+    {
+        fprintf(stderr, "%s is not a valid binary PPM file, too short\n", file);
+        close(fd);
+        return NULL;
+    }
+
+    size_t length = status.st_size;
+    void * base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "can't map PPM file %s\n", file);
+        return NULL;
+    }
+
+    // Header: P6, Width, Height, Maximum, one Whitespace
+    const char * start = (const char *) base;
+    const char * end = start + length;
+    const char * at = start + 2;
+    int nx = 0, ny = 0, pvmax = 0;
+
+    if ((start[0] != 'P') || (start[1] != '6') ||
+        ((at = headerNumber(at, end, &nx)) == NULL) ||
+        ((at = headerNumber(at, end, &ny)) == NULL) ||
+        ((at = headerNumber(at, end, &pvmax)) == NULL) ||
+        (at >= end) || !isspace((unsigned char) *at))
+    {
+        fprintf(stderr, "%s is not a valid binary PPM file, bad header\n", file);
+        munmap(base, length);
+        return NULL;
+    }
+    at++;
+
+    if (pvmax != 255)
+    {
+        fprintf(stderr, "%s does not have 8-bit components: pvmax=%d\n", file, pvmax);
+        munmap(base, length);
+        return NULL;
+    }
+
+    if ((size_t) (end - at) < (size_t) nx * ny * 3)
+    {
+        fprintf(stderr, "premature EOF on file %s\n", file);
+        munmap(base, length);
+        return NULL;
+    }
+
+    struct mappedPic * mapped = (struct mappedPic *) malloc(sizeof(struct mappedPic));
+    if (mapped == NULL)
+    {
+        munmap(base, length);
+        return NULL;
+    }
+
+    mapped->pic.nx = nx;
+    mapped->pic.ny = ny;
+    mapped->pic.bpp = 3;
+    mapped->pic.pix = (Pixel1 *) at;
+    mapped->base = base;
+    mapped->length = length;
+
+    return mapped;
+}
+
+/**
+ * ppm_map - Maps a binary PPM File, the Pixels are Read straight
+ *           from the Page Cache without a Copy
+ */
+Pic *ppm_map(char *file)
+{
+    struct mappedPic * mapped = mapFile(file);
+    if (mapped == NULL)
+    {
+        return NULL;
+    }
+
+    madvise(mapped->base, mapped->length, MADV_SEQUENTIAL);
+    return &mapped->pic;
+}
+
+/**
+ * ppm_unmap - Releases a Pic from ppm_map or ppm_batch_next
+ */
+void ppm_unmap(Pic *p)
+{
+    if (p == NULL)
+    {
+        return;
+    }
+
+    struct mappedPic * mapped = (struct mappedPic *) p;
+    munmap(mapped->base, mapped->length);
+    free(mapped);
+}
+
+/**
+ * fillBatch - Maps the Files up to 'ahead' in advance, and
+ *             has the Kernel start Reading them
+ */
+static void fillBatch(Ppm_batch *batch)
+{
+    while ((batch->mapped < batch->count) && (batch->mapped - batch->next < batch->ahead))
+    {
+        struct mappedPic * mapped = mapFile(batch->files[batch->mapped]);
+        if (mapped != NULL)
+        {
+            madvise(mapped->base, mapped->length, MADV_WILLNEED);
+        }
+
+        batch->ring[batch->mapped % batch->ahead] = mapped;
+        batch->mapped++;
+    }
+}
+
+/**
+ * ppm_batch_open - Starts Mapping a List of PPM Files in Order
+ */
+Ppm_batch *ppm_batch_open(char **files, int count, int ahead)
+{
+    Ppm_batch *batch = (Ppm_batch *) malloc(sizeof(Ppm_batch));
+    if (batch == NULL)
+    {
+        return NULL;
+    }
+
+    batch->files = files;
+    batch->count = count;
+    batch->ahead = (ahead > 0) ? ahead : 1;
+    batch->next = 0;
+    batch->mapped = 0;
+    batch->ring = (struct mappedPic **) calloc(batch->ahead, sizeof(struct mappedPic *));
+    if (batch->ring == NULL)
+    {
+        free(batch);
+        return NULL;
+    }
+
+    fillBatch(batch);
+    return batch;
+}
+
+/**
+ * ppm_batch_next - Hands out the Next File of the Batch
+ */
+Pic *ppm_batch_next(Ppm_batch *batch)
+{
+    if (batch->next >= batch->count)
+    {
+        return NULL;
+    }
+
+    struct mappedPic * mapped = batch->ring[batch->next % batch->ahead];
+    batch->ring[batch->next % batch->ahead] = NULL;
+    batch->next++;
+
+    fillBatch(batch);
+
+    if (mapped == NULL)
+    {
+        return NULL;
+    }
+
+    madvise(mapped->base, mapped->length, MADV_SEQUENTIAL);
+    return &mapped->pic;
+}
+
+/**
+ * ppm_batch_close - Unmaps the Files not Handed out yet
+ */
+void ppm_batch_close(Ppm_batch *batch)
+{
+    for (int i=batch->next; i<batch->mapped; i++)
+    {
+        struct mappedPic * mapped = batch->ring[i % batch->ahead];
+        if (mapped != NULL)
+        {
+            ppm_unmap(&mapped->pic);
+        }
+    }
+
+    free(batch->ring);
+    free(batch);
+}
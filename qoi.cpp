@@ -0,0 +1,150 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "pic.h"
+
+// QOI Chunk Tags
+const unsigned char QOI_OP_INDEX = 0x00; // 2-bit tag, 6-bit index into the recent colors
+const unsigned char QOI_OP_DIFF = 0x40;  // 2-bit tag, 2-bit differences of r, g and b
+const unsigned char QOI_OP_LUMA = 0x80;  // 2-bit tag, 6-bit difference of g (and a byte for r, b)
+const unsigned char QOI_OP_RUN = 0xc0;   // 2-bit tag, 6-bit run length - 1
+const unsigned char QOI_OP_RGB = 0xfe;   // 8-bit tag, followed by r, g and b
+const int QOI_MAX_RUN = 62;              // longest run of one chunk
+
+/**
+ * putBigEndian - Stores a 32-bit Value Most Significant Byte First
+ */
+static unsigned char * putBigEndian(unsigned char * out, unsigned int value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+    return out + 4;
+}
+
+/**
+ * qoi_write - Writes pic (3 bytes per pixel) to file as a QOI
+ *             Image, encoded in Memory and Written at once
+ */
+int qoi_write(char *file, Pic *pic)
+{
+    if (pic->bpp != 3)
+    {
+        fprintf(stderr, "qoi_write: can't write %d byte per pixel Pic\n", pic->bpp);
+        return FALSE;
+    }
+
+    // Worst Case: Header, one RGB Chunk per Pixel, End Marker
+    int pixels = pic->nx * pic->ny;
+    std::vector<unsigned char> encoded(14 + 4 * pixels + 8);
+    unsigned char * out = &encoded[0];
+
+    // Header
+    memcpy(out, "qoif", 4);
+    out = putBigEndian(out + 4, pic->nx);
+    out = putBigEndian(out, pic->ny);
+    *out++ = 3; // channels
+    *out++ = 0; // sRGB
+
+    // Colors Seen Recently, Hashed by Color (all Alpha 255)
+    unsigned int recent[64];
+    memset(recent, 0, sizeof(recent));
+
+    unsigned char r = 0, g = 0, b = 0;
+    int run = 0;
+    const Pixel1 * pix = pic->pix;
+
+    for (int i=0; i<pixels; i++, pix += 3)
+    {
+        // Extend the Run of the Previous Color
+        if ((pix[0] == r) && (pix[1] == g) && (pix[2] == b))
+        {
+            run++;
+            if ((run == QOI_MAX_RUN) || (i == pixels - 1))
+            {
+                *out++ = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0)
+        {
+            *out++ = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        // Reuse a Recent Color
+        unsigned int color = pix[0] | (pix[1] << 8) | (pix[2] << 16) | (255u << 24);
+        int hash = (pix[0] * 3 + pix[1] * 5 + pix[2] * 7 + 255 * 11) % 64;
+
+        if (recent[hash] == color)
+        {
+            *out++ = QOI_OP_INDEX | hash;
+        }
+        else
+        {
+            recent[hash] = color;
+
+            // Small Differences to the Previous Color
+            signed char dr = pix[0] - r;
+            signed char dg = pix[1] - g;
+            signed char db = pix[2] - b;
+            signed char drg = dr - dg;
+            signed char dbg = db - dg;
+
+            if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1))
+            {
+                *out++ = QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+            }
+            else if ((dg >= -32) && (dg <= 31) && (drg >= -8) && (drg <= 7) && (dbg >= -8) && (dbg <= 7))
+            {
+                *out++ = QOI_OP_LUMA | (dg + 32);
+                *out++ = ((drg + 8) << 4) | (dbg + 8);
+            }
+            else
+            {
+                *out++ = QOI_OP_RGB;
+                *out++ = pix[0];
+                *out++ = pix[1];
+                *out++ = pix[2];
+            }
+        }
+
+        r = pix[0];
+        g = pix[1];
+        b = pix[2];
+    }
+
+    // End Marker
+    static const unsigned char end[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(out, end, sizeof(end));
+    out += sizeof(end);
+
+    FILE *qoi = fopen(file, "wb");
+    if (!qoi)
+    {
+        return FALSE;
+    }
+
+    size_t size = out - &encoded[0];
+    if (fwrite(&encoded[0], 1, size, qoi) != size)
+    {
+        fprintf(stderr, "qoi_write: error writing %s\n", file);
+        fclose(qoi);
+        return FALSE;
+    }
+
+    fclose(qoi);
+    return TRUE;
+}
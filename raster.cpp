@@ -0,0 +1,590 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "surfaceMesh.h"
+#include "threadPool.h"
+#include "raster.h"
+#include <algorithm>
+
+// Camera Constants (as set up by setProjection)
+const double RASTER_FOVY = 60.0;   // vertical field of view in degrees
+const double RASTER_NEAR = 0.01;   // near plane, primitives reaching behind it are dropped
+const double RASTER_FAR = 1000.0;  // far plane
+
+// Material and Lights (as set up by drawScene)
+const double MATERIAL_DIFFUSE = 0.3;
+const double MATERIAL_SPECULAR = 1.0;
+const double MATERIAL_SHININESS = 60.0;
+const double LIGHT_POSITION = 1.999;                // the lights sit in the corners of the bounding box
+const double CLEAR_COLOR = 0.2;                     // dark gray background
+const double POINT_RADIUS = 2;                      // points are 5 pixels wide
+const double LINE_RADIUS = 1.0;                     // smooth lines cover 2 pixels across without blending
+
+// Primitive Types
+enum { RASTER_POINT, RASTER_LINE, RASTER_TRIANGLE };
+
+// Vertex after the Camera and Lighting, in Window Coordinates
+struct rasterVertex
+{
+    double x, y, z; // pixel position (y up) and depth in [0,1]
+    double q;       // 1 / clip w, for perspective-correct colors (0 if behind the near plane)
+    double r, g, b; // lit color
+};
+
+// Primitive to Rasterize, in Drawing Order
+struct rasterPrimitive
+{
+    int type;
+    int v[3];            // vertices (points use v[0], lines v[0] and v[1])
+    double r, g, b;      // color of points and lines
+    int x0, y0, x1, y1;  // pixels it may cover
+};
+
+// Frame State, reused between Frames
+static std::vector<struct rasterVertex> vertices;
+static std::vector<struct rasterPrimitive> primitives;
+static std::vector<std::vector<int> > bins; // primitives overlapping every tile, in drawing order
+static std::vector<float> depth;
+
+// Camera of the Frame
+static struct point eye, side, up, forward;
+static double focalX, focalY;
+static int width, height;
+
+/**
+ * setupCamera - Builds the Camera of gluLookAt and gluPerspective
+ */
+static void setupCamera(int w, int h)
+{
+    double length;
+
+    width = w;
+    height = h;
+
+    // Look at the Origin, Z up
+    eye.x = R * cos(Phi) * cos(Theta);
+    eye.y = R * sin(Phi) * cos(Theta);
+    eye.z = R * sin(Theta);
+
+    pMULTIPLY(eye, -1.0, forward);
+    pNORMALIZE(forward);
+
+    struct point z;
+    z.x = 0.0; z.y = 0.0; z.z = 1.0;
+    CROSSPRODUCTp(forward, z, side);
+    pNORMALIZE(side);
+    CROSSPRODUCTp(side, forward, up);
+
+    focalY = 1.0 / tan(RASTER_FOVY * pi / 360.0);
+    focalX = focalY * height / width;
+}
+
+/**
+ * projectVertex - Transforms a Point into Window Coordinates
+ */
+static void projectVertex(const struct point & p, struct rasterVertex & vertex)
+{
+    struct point d;
+    double xe, ye, ze;
+
+    pDIFFERENCE(p, eye, d);
+    DOTPRODUCTp(d, side, xe);
+    DOTPRODUCTp(d, up, ye);
+    DOTPRODUCTp(d, forward, ze); // distance in front of the eye, the clip w
+
+    if (ze < RASTER_NEAR)
+    {
+        vertex.q = 0.0;
+        return;
+    }
+
+    // Perspective Divide and Viewport
+    double zc = -(RASTER_FAR + RASTER_NEAR) / (RASTER_NEAR - RASTER_FAR) * ze + 2.0 * RASTER_FAR * RASTER_NEAR / (RASTER_NEAR - RASTER_FAR);
+    vertex.q = 1.0 / ze;
+    vertex.x = (focalX * xe * vertex.q + 1.0) * 0.5 * width;
+    vertex.y = (focalY * ye * vertex.q + 1.0) * 0.5 * height;
+    vertex.z = (zc * vertex.q + 1.0) * 0.5;
+}
+
+/**
+ * lightVertex - Lights a Vertex with the 8 Lights of drawScene
+ *               (local viewer, normals used as they are)
+ */
+static void lightVertex(const struct point & p, const struct point & n, struct rasterVertex & vertex)
+{
+    struct point view, light, half;
+    double length, nDotL, nDotH;
+
+    vertex.r = vertex.g = vertex.b = 0.0;
+
+    pDIFFERENCE(eye, p, view);
+    pNORMALIZE(view);
+
+    for (int l=0; l<8; l++)
+    {
+        // Lights in the Corners of the Box, alternating Cyan and Yellow
+        light.x = ((((l + 1) / 2) % 2) ? LIGHT_POSITION : -LIGHT_POSITION) - p.x;
+        light.y = (((l / 2) % 2) ? LIGHT_POSITION : -LIGHT_POSITION) - p.y;
+        light.z = ((l / 4) ? LIGHT_POSITION : -LIGHT_POSITION) - p.z;
+        pNORMALIZE(light);
+
+        DOTPRODUCTp(n, light, nDotL);
+        if (nDotL <= 0.0)
+        {
+            continue;
+        }
+
+        pSUM(light, view, half);
+        pNORMALIZE(half);
+        DOTPRODUCTp(n, half, nDotH);
+
+        double intensity = nDotL * MATERIAL_DIFFUSE + pow(std::max(nDotH, 0.0), MATERIAL_SHININESS) * MATERIAL_SPECULAR;
+        vertex.r += (l % 2) ? intensity : 0.0;
+        vertex.g += intensity;
+        vertex.b += (l % 2) ? 0.0 : intensity;
+    }
+
+    vertex.r = std::min(vertex.r, 1.0);
+    vertex.g = std::min(vertex.g, 1.0);
+    vertex.b = std::min(vertex.b, 1.0);
+}
+
+/**
+ * addPrimitive - Adds a Primitive if all its Vertices are
+ *                in front of the Camera and it is in the Image
+ */
+static void addPrimitive(int type, int v0, int v1, int v2, double r, double g, double b)
+{
+    struct rasterPrimitive primitive;
+    int count = (type == RASTER_POINT) ? 1 : ((type == RASTER_LINE) ? 2 : 3);
+    double x0 = 1e30, y0 = 1e30, x1 = -1e30, y1 = -1e30;
+
+    primitive.type = type;
+    primitive.v[0] = v0;
+    primitive.v[1] = v1;
+    primitive.v[2] = v2;
+    primitive.r = r;
+    primitive.g = g;
+    primitive.b = b;
+
+    for (int c=0; c<count; c++)
+    {
+        struct rasterVertex & vertex = vertices[primitive.v[c]];
+        if (vertex.q == 0.0)
+        {
+            return;
+        }
+
+        x0 = std::min(x0, vertex.x);
+        y0 = std::min(y0, vertex.y);
+        x1 = std::max(x1, vertex.x);
+        y1 = std::max(y1, vertex.y);
+    }
+
+    // Drop the Back Faces
+    if (type == RASTER_TRIANGLE)
+    {
+        struct rasterVertex & a = vertices[v0];
+        struct rasterVertex & b = vertices[v1];
+        struct rasterVertex & c = vertices[v2];
+
+        if ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y) <= 0.0)
+        {
+            return;
+        }
+    }
+
+    // Pixels it may Cover
+    if (type == RASTER_POINT)
+    {
+        x0 = floor(x0) - POINT_RADIUS;
+        y0 = floor(y0) - POINT_RADIUS;
+        x1 = floor(x1) + POINT_RADIUS;
+        y1 = floor(y1) + POINT_RADIUS;
+    }
+    else if (type == RASTER_LINE)
+    {
+        x0 -= LINE_RADIUS;
+        y0 -= LINE_RADIUS;
+        x1 += LINE_RADIUS;
+        y1 += LINE_RADIUS;
+    }
+    primitive.x0 = (int) std::max(floor(x0), 0.0);
+    primitive.y0 = (int) std::max(floor(y0), 0.0);
+    primitive.x1 = (int) std::min(ceil(x1), width - 1.0);
+    primitive.y1 = (int) std::min(ceil(y1), height - 1.0);
+
+    if ((primitive.x0 > primitive.x1) || (primitive.y0 > primitive.y1))
+    {
+        return;
+    }
+
+    primitives.push_back(primitive);
+}
+
+/**
+ * setupBody - Transforms and Lights the Vertices of a Body
+ */
+static void setupBody(struct point * p, struct point * normal, int first)
+{
+    if (viewingMode == 0)
+    {
+        // Mass Points
+        for (int n=0; n<512; n++)
+        {
+            projectVertex(p[n], vertices[first + n]);
+        }
+    }
+    else
+    {
+        // Face Vertices
+        for (int v=0; v<FACE_VERTICES; v++)
+        {
+            projectVertex(p[surface.faceNode[v]], vertices[first + v]);
+            lightVertex(p[surface.faceNode[v]], normal[v], vertices[first + v]);
+        }
+    }
+}
+
+/**
+ * addLines - Adds the Springs of one Type of a Body
+ */
+static void addLines(const std::vector<unsigned short> & lines, int first, double r, double g, double b)
+{
+    for (size_t l=0; l<lines.size(); l+=2)
+    {
+        addPrimitive(RASTER_LINE, first + lines[l], first + lines[l+1], 0, r, g, b);
+    }
+}
+
+/**
+ * setupScene - Builds the Vertices and Primitives of the Frame
+ *              in the Drawing Order of drawScene
+ */
+static void setupScene(std::vector<struct point> & positions, std::vector<struct point> & normals)
+{
+    int bodies = positions.size() / 512;
+    int stride = (viewingMode == 0) ? 512 : FACE_VERTICES;
+
+    // Bodies, then the 80 Ends of the Lines of the Bounding Box
+    vertices.resize(bodies * stride + 80);
+    primitives.clear();
+
+    for (int b=0; b<bodies; b++)
+    {
+        if (fabs(positions[512 * b].x) > 10)
+        {
+            printf ("Your cube somehow escaped way out of the box.\n");
+            exit(0);
+        }
+    }
+
+    parallelFor(bodies, 1, [&](int begin, int end)
+    {
+        for (int b=begin; b<end; b++)
+        {
+            setupBody(&positions[512 * b], &normals[FACE_VERTICES * b], b * stride);
+        }
+    });
+
+    for (int b=0; b<bodies; b++)
+    {
+        int first = b * stride;
+
+        if (viewingMode == 0)
+        {
+            for (int s=0; s<SURFACE_VERTICES; s++)
+            {
+                addPrimitive(RASTER_POINT, first + surface.wirePoint[s], 0, 0, 0.8, 0.8, 0.8);
+            }
+
+            if (structural == 1)
+            {
+                addLines(surface.structuralLines, first, 0, 0, 1);
+            }
+            if (shear == 1)
+            {
+                addLines(surface.shearLines, first, 0, 1, 0);
+            }
+            if (bend == 1)
+            {
+                addLines(surface.bendLines, first, 1, 0, 0);
+            }
+        }
+        else
+        {
+            for (int t=0; t<SURFACE_TRIANGLES; t++)
+            {
+                unsigned short * triangle = surface.faceTriangle[t];
+                addPrimitive(RASTER_TRIANGLE, first + triangle[0], first + triangle[1], first + triangle[2], 0, 0, 0);
+            }
+        }
+    }
+
+    // Bounding Box, the Grid on its Front, Back, Left and Right Faces
+    int first = bodies * stride;
+    int end = first;
+    for (int face=0; face<4; face++)
+    {
+        double wall = (face % 2) ? 2.0 : -2.0;
+
+        for (int i=-2; i<=2; i++)
+        {
+            struct point line[4];
+
+            // lines along z, then across z
+            line[0].x = i; line[0].y = wall; line[0].z = -2;
+            line[1].x = i; line[1].y = wall; line[1].z = 2;
+            line[2].x = -2; line[2].y = wall; line[2].z = i;
+            line[3].x = 2; line[3].y = wall; line[3].z = i;
+
+            for (int e=0; e<4; e++)
+            {
+                // the left and right faces are the front and back ones turned
+                if (face >= 2)
+                {
+                    std::swap(line[e].x, line[e].y);
+                }
+                projectVertex(line[e], vertices[end + e]);
+            }
+
+            addPrimitive(RASTER_LINE, end, end + 1, 0, 0.8, 0.8, 0.8);
+            addPrimitive(RASTER_LINE, end + 2, end + 3, 0, 0.8, 0.8, 0.8);
+            end += 4;
+        }
+    }
+}
+
+/**
+ * writePixel - Depth Tests a Fragment and Writes its Color
+ */
+static inline void writePixel(Pic * pic, int x, int y, double z, double r, double g, double b)
+{
+    float & stored = depth[y * width + x];
+
+    if (!((float) z < stored))
+    {
+        return;
+    }
+    stored = z;
+
+    Pixel1 * pixel = &pic->pix[((height - 1 - y) * width + x) * 3];
+    pixel[0] = (Pixel1) (r * 255.0 + 0.5);
+    pixel[1] = (Pixel1) (g * 255.0 + 0.5);
+    pixel[2] = (Pixel1) (b * 255.0 + 0.5);
+}
+
+/**
+ * rasterizeTriangle - Fills the Pixels of a Front Facing Triangle
+ *                     whose Centers are inside it, with Perspective
+ *                     Correct Gouraud Colors
+ */
+static void rasterizeTriangle(Pic * pic, const struct rasterPrimitive & primitive, int x0, int y0, int x1, int y1)
+{
+    const struct rasterVertex * v[3] = { &vertices[primitive.v[0]], &vertices[primitive.v[1]], &vertices[primitive.v[2]] };
+    double area = (v[1]->x - v[0]->x) * (v[2]->y - v[0]->y) - (v[2]->x - v[0]->x) * (v[1]->y - v[0]->y);
+
+    // Edge e is opposite Vertex e; Pixel Centers exactly on an Edge
+    // belong to the Triangle left of it or below it (top-left rule, y up)
+    double ex[3], ey[3];
+    bool owned[3];
+    for (int e=0; e<3; e++)
+    {
+        const struct rasterVertex * a = v[(e + 1) % 3];
+        const struct rasterVertex * b = v[(e + 2) % 3];
+        ex[e] = b->x - a->x;
+        ey[e] = b->y - a->y;
+        owned[e] = (ey[e] < 0.0) || ((ey[e] == 0.0) && (ex[e] < 0.0));
+    }
+
+    for (int y=y0; y<=y1; y++)
+    {
+        double py = y + 0.5;
+
+        for (int x=x0; x<=x1; x++)
+        {
+            double px = x + 0.5;
+            double w[3];
+            bool inside = true;
+
+            for (int e=0; e<3; e++)
+            {
+                const struct rasterVertex * a = v[(e + 1) % 3];
+                w[e] = ex[e] * (py - a->y) - ey[e] * (px - a->x);
+                inside = inside && ((w[e] > 0.0) || ((w[e] == 0.0) && owned[e]));
+            }
+
+            if (!inside)
+            {
+                continue;
+            }
+
+            // Barycentric Weights
+            double b0 = w[0] / area, b1 = w[1] / area, b2 = w[2] / area;
+            double z = b0 * v[0]->z + b1 * v[1]->z + b2 * v[2]->z;
+
+            // Perspective Correct Colors
+            double q0 = b0 * v[0]->q, q1 = b1 * v[1]->q, q2 = b2 * v[2]->q;
+            double q = q0 + q1 + q2;
+
+            writePixel(pic, x, y, z,
+                       (q0 * v[0]->r + q1 * v[1]->r + q2 * v[2]->r) / q,
+                       (q0 * v[0]->g + q1 * v[1]->g + q2 * v[2]->g) / q,
+                       (q0 * v[0]->b + q1 * v[1]->b + q2 * v[2]->b) / q);
+        }
+    }
+}
+
+/**
+ * rasterizeLine - Draws a Line the way GL_LINE_SMOOTH covers it
+ *                 without blending: per Column (or Row) whose
+ *                 Center it Crosses, the Pixels whose Centers are
+ *                 less than LINE_RADIUS away across the Line
+ */
+static void rasterizeLine(Pic * pic, const struct rasterPrimitive & primitive, int x0, int y0, int x1, int y1)
+{
+    const struct rasterVertex & a = vertices[primitive.v[0]];
+    const struct rasterVertex & b = vertices[primitive.v[1]];
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+
+    // Step along the Major Axis
+    bool xMajor = (fabs(dx) >= fabs(dy));
+    double start = xMajor ? a.x : a.y;
+    double delta = xMajor ? dx : dy;
+    if (delta == 0.0)
+    {
+        return;
+    }
+
+    int lo = (int) ceil(std::min(start, start + delta) - 0.5);
+    int hi = (int) ceil(std::max(start, start + delta) - 0.5) - 1;
+    lo = std::max(lo, xMajor ? x0 : y0);
+    hi = std::min(hi, xMajor ? x1 : y1);
+
+    for (int i=lo; i<=hi; i++)
+    {
+        double t = (i + 0.5 - start) / delta;
+        double minor = xMajor ? (a.y + t * dy) : (a.x + t * dx);
+        double z = a.z + t * (b.z - a.z);
+
+        for (int m=(int) floor(minor - LINE_RADIUS - 0.5) + 1; m<=(int) ceil(minor + LINE_RADIUS - 0.5) - 1; m++)
+        {
+            int x = xMajor ? i : m;
+            int y = xMajor ? m : i;
+
+            if ((x < x0) || (x > x1) || (y < y0) || (y > y1))
+            {
+                continue;
+            }
+
+            writePixel(pic, x, y, z, primitive.r, primitive.g, primitive.b);
+        }
+    }
+}
+
+/**
+ * rasterizePoint - Draws a Square Point
+ */
+static void rasterizePoint(Pic * pic, const struct rasterPrimitive & primitive, int x0, int y0, int x1, int y1)
+{
+    const struct rasterVertex & a = vertices[primitive.v[0]];
+
+    for (int y=std::max(primitive.y0, y0); y<=std::min(primitive.y1, y1); y++)
+    {
+        for (int x=std::max(primitive.x0, x0); x<=std::min(primitive.x1, x1); x++)
+        {
+            writePixel(pic, x, y, a.z, primitive.r, primitive.g, primitive.b);
+        }
+    }
+}
+
+/**
+ * rasterizeTile - Clears a Tile and Draws the Primitives
+ *                 overlapping it
+ */
+static void rasterizeTile(Pic * pic, int tile)
+{
+    int tilesX = (width + RASTER_TILE - 1) / RASTER_TILE;
+    int x0 = (tile % tilesX) * RASTER_TILE;
+    int y0 = (tile / tilesX) * RASTER_TILE;
+    int x1 = std::min(x0 + RASTER_TILE, width) - 1;
+    int y1 = std::min(y0 + RASTER_TILE, height) - 1;
+
+    // Clear
+    Pixel1 clear = (Pixel1) (CLEAR_COLOR * 255.0 + 0.5);
+    for (int y=y0; y<=y1; y++)
+    {
+        memset(&pic->pix[((height - 1 - y) * width + x0) * 3], clear, (x1 - x0 + 1) * 3);
+        std::fill(&depth[y * width + x0], &depth[y * width + x1] + 1, 1.0f);
+    }
+
+    // Draw
+    for (size_t n=0; n<bins[tile].size(); n++)
+    {
+        const struct rasterPrimitive & primitive = primitives[bins[tile][n]];
+        int px0 = std::max(primitive.x0, x0);
+        int py0 = std::max(primitive.y0, y0);
+        int px1 = std::min(primitive.x1, x1);
+        int py1 = std::min(primitive.y1, y1);
+
+        switch (primitive.type)
+        {
+        case RASTER_TRIANGLE:
+            rasterizeTriangle(pic, primitive, px0, py0, px1, py1);
+            break;
+        case RASTER_LINE:
+            rasterizeLine(pic, primitive, px0, py0, px1, py1);
+            break;
+        case RASTER_POINT:
+            rasterizePoint(pic, primitive, px0, py0, px1, py1);
+            break;
+        }
+    }
+}
+
+/**
+ * rasterizeScene - Renders the Scene on the CPU, Tile by Tile
+ */
+void rasterizeScene(Pic * pic, std::vector<struct point> & positions, std::vector<struct point> & normals)
+{
+    setupCamera(pic->nx, pic->ny);
+    setupScene(positions, normals);
+
+    // Sort the Primitives into the Tiles they Overlap, keeping their Order
+    int tilesX = (width + RASTER_TILE - 1) / RASTER_TILE;
+    int tilesY = (height + RASTER_TILE - 1) / RASTER_TILE;
+    bins.resize(tilesX * tilesY);
+    for (size_t t=0; t<bins.size(); t++)
+    {
+        bins[t].clear();
+    }
+
+    for (size_t n=0; n<primitives.size(); n++)
+    {
+        for (int ty=primitives[n].y0 / RASTER_TILE; ty<=primitives[n].y1 / RASTER_TILE; ty++)
+        {
+            for (int tx=primitives[n].x0 / RASTER_TILE; tx<=primitives[n].x1 / RASTER_TILE; tx++)
+            {
+                bins[ty * tilesX + tx].push_back(n);
+            }
+        }
+    }
+
+    // Every Tile owns its Pixels, so the Tiles need no Locks
+    depth.resize(width * height);
+    parallelFor(tilesX * tilesY, 1, [&](int begin, int end)
+    {
+        for (int tile=begin; tile<end; tile++)
+        {
+            rasterizeTile(pic, tile);
+        }
+    });
+}
+
@@ -0,0 +1,25 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _RASTER_H_
+#define _RASTER_H_
+
+#include <vector>
+#include "pic.h"
+
+// size of the square tiles the image is split into, one tile per job of the worker threads
+#define RASTER_TILE 32
+
+// renders the jellos at 'positions' (with the normals of their face vertices,
+// see computeFaceNormals) and the bounding box into 'pic' (3 bytes per pixel,
+// top row first) on the CPU, the way drawScene does with OpenGL: the same
+// camera, the 8 lights with Gouraud shading in triangle mode, and the points
+// and springs in wireframe mode. The tiles are rasterized on the shared workers.
+void rasterizeScene(Pic * pic, std::vector<struct point> & positions, std::vector<struct point> & normals);
+
+#endif
+
@@ -0,0 +1,322 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "input.h"
+#include "simulation.h"
+#include "tuning.h"
+#include "reload.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#if defined(linux)
+  #include <sys/inotify.h>
+  #include <sys/uio.h>
+  #include <poll.h>
+  #include <errno.h>
+#endif
+
+// Reload Constants
+const int RELOAD_SETTLE_TIME = 50; // milliseconds without events before a saved file is read (editors write in bursts)
+
+// Represents a World File watched for Changes
+struct watchedFile
+{
+    std::string path;                      // path the file was read from
+    std::string name;                      // file name inside its directory
+    int watch;                             // inotify watch of its directory
+    std::atomic<struct world *> pending;   // parsed world waiting for the physics thread, or NULL
+};
+
+// Represents the State of the Reloader
+// (never freed, see threadPool.cpp)
+struct reloader
+{
+    std::vector<struct watchedFile *> files; // distinct world files of the scene
+    struct scene * scene;                    // scene the files belong to
+    int keepState;                           // keep positions and velocities on reload? 1 = YES, 0 = NO
+    int fd;                                  // inotify instance
+};
+
+static struct reloader * watcher = NULL;
+
+/**
+ * reloadFile - Reparses a Changed World File and hands it
+ *              to the Physics Thread
+ */
+static void reloadFile(struct watchedFile * file)
+{
+    struct world * jello = new world();
+
+    // Keep the Running World if the File is Broken or still being Written
+    if (!parseWorld(file->path.c_str(), jello))
+    {
+        printf("Can't reload %s, keeping the running world\n", file->path.c_str());
+        delete jello;
+        return;
+    }
+
+    printf("Reloaded %s\n", file->path.c_str());
+
+    // Keep the Parameter Block in Step, so Tuning continues from the New Values
+    struct parameters values;
+    values.kElastic = jello->kElastic;
+    values.dElastic = jello->dElastic;
+    values.kCollision = jello->kCollision;
+    values.dCollision = jello->dCollision;
+    values.mass = jello->mass;
+
+    for (size_t b=0; b<watcher->scene->files.size(); b++)
+    {
+        if (watcher->scene->files[b] == file->path)
+        {
+            setParameters(b, values);
+        }
+    }
+
+    // Hand it over, replacing a Reload the Physics Thread has not taken yet
+    struct world * stale = file->pending.exchange(jello);
+    if (stale != NULL)
+    {
+        free(stale->forceField);
+        delete stale;
+    }
+
+    notifySimulation();
+}
+
+#if defined(linux)
+
+/**
+ * reloadLoop - Main Loop of the Watching Thread
+ */
+static void reloadLoop()
+{
+    char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    std::vector<bool> changed(watcher->files.size());
+
+    for (;;)
+    {
+        // Wait for Events, then Collect them until the Writes Settle
+        int timeout = -1;
+        bool any = false;
+
+        for (;;)
+        {
+            struct pollfd poller;
+            poller.fd = watcher->fd;
+            poller.events = POLLIN;
+
+            int ready = poll(&poller, 1, timeout);
+            if ((ready < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+            if (ready <= 0)
+            {
+                break;
+            }
+
+            // (readv, as unistd.h clashes with the 'pause' flag)
+            struct iovec buffer;
+            buffer.iov_base = events;
+            buffer.iov_len = sizeof(events);
+
+            ssize_t length = readv(watcher->fd, &buffer, 1);
+            if (length <= 0)
+            {
+                if ((length < 0) && (errno == EINTR))
+                {
+                    continue;
+                }
+                return;
+            }
+
+            // Mark the Watched Files the Events are about
+            for (char * e = events; e < events + length; e += sizeof(struct inotify_event) + ((struct inotify_event *)e)->len)
+            {
+                struct inotify_event * event = (struct inotify_event *)e;
+
+                for (size_t f=0; f<watcher->files.size(); f++)
+                {
+                    if ((event->len > 0) && (event->wd == watcher->files[f]->watch) &&
+                        (watcher->files[f]->name == event->name))
+                    {
+                        changed[f] = true;
+                        any = true;
+                    }
+                }
+            }
+
+            timeout = RELOAD_SETTLE_TIME;
+        }
+
+        // Reparse the Changed Files
+        for (size_t f=0; any && (f<watcher->files.size()); f++)
+        {
+            if (changed[f])
+            {
+                changed[f] = false;
+                reloadFile(watcher->files[f]);
+            }
+        }
+    }
+}
+
+#endif
+
+/**
+ * startReload - Starts Watching the World Files of the Scene
+ */
+void startReload(struct scene * scene, int keepState)
+{
+    // Only Start once
+    if (watcher != NULL)
+    {
+        return;
+    }
+
+    watcher = new struct reloader();
+    watcher->scene = scene;
+    watcher->keepState = keepState;
+    watcher->fd = -1;
+
+    // Collect the Distinct World Files
+    for (size_t b=0; b<scene->files.size(); b++)
+    {
+        bool known = false;
+        for (size_t f=0; f<watcher->files.size(); f++)
+        {
+            known = known || (watcher->files[f]->path == scene->files[b]);
+        }
+
+        if (!known)
+        {
+            struct watchedFile * file = new watchedFile();
+            file->path = scene->files[b];
+            file->watch = -1;
+            file->pending = NULL;
+            watcher->files.push_back(file);
+        }
+    }
+
+#if defined(linux)
+    watcher->fd = inotify_init();
+    if (watcher->fd < 0)
+    {
+        printf("Can't watch the world files, hot reload is off\n");
+        return;
+    }
+
+    // Watch the Directories, so Editors replacing the File are seen too
+    for (size_t f=0; f<watcher->files.size(); f++)
+    {
+        struct watchedFile * file = watcher->files[f];
+        size_t slash = file->path.find_last_of('/');
+        std::string directory = (slash == std::string::npos) ? "." : file->path.substr(0, slash + 1);
+        file->name = (slash == std::string::npos) ? file->path : file->path.substr(slash + 1);
+
+        file->watch = inotify_add_watch(watcher->fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (file->watch < 0)
+        {
+            printf("Can't watch %s\n", file->path.c_str());
+        }
+    }
+
+    std::thread(reloadLoop).detach();
+#endif
+}
+
+/**
+ * applyReload - Swaps the Reloaded World Files into their Bodies
+ */
+int applyReload(struct scene * scene)
+{
+    int reloaded = 0;
+
+    if (watcher == NULL)
+    {
+        return 0;
+    }
+
+    for (size_t f=0; f<watcher->files.size(); f++)
+    {
+        // Take the Newest Reload of the File
+        struct world * file = watcher->files[f]->pending.exchange(NULL);
+        if (file == NULL)
+        {
+            continue;
+        }
+
+        // Force Field shared by the Bodies read from the File
+        struct point * oldField = NULL;
+
+        for (size_t b=0; b<scene->bodies.size(); b++)
+        {
+            if (scene->files[b] != watcher->files[f]->path)
+            {
+                continue;
+            }
+
+            struct world * jello = scene->bodies[b];
+            oldField = jello->forceField;
+
+            // Swap in the Parameters and the Force Field
+            strcpy(jello->integrator, file->integrator);
+            jello->dt = file->dt;
+            jello->n = file->n;
+            jello->kElastic = file->kElastic;
+            jello->dElastic = file->dElastic;
+            jello->kCollision = file->kCollision;
+            jello->dCollision = file->dCollision;
+            jello->mass = file->mass;
+            jello->invMass = file->invMass;
+            jello->incPlanePresent = file->incPlanePresent;
+            jello->a = file->a;
+            jello->b = file->b;
+            jello->c = file->c;
+            jello->d = file->d;
+            jello->resolution = file->resolution;
+            jello->forceField = file->forceField;
+
+            // Restart from the File, Moved to the Place of the Body in the Scene
+            if (!watcher->keepState)
+            {
+                for (int i=0; i<=7; i++)
+                {
+                    for (int j=0; j<=7; j++)
+                    {
+                        for (int k=0; k<=7; k++)
+                        {
+                            pSUM(file->p[i][j][k], scene->offsets[b], jello->p[i][j][k]);
+                            jello->v[i][j][k] = file->v[i][j][k];
+                        }
+                    }
+                }
+            }
+
+            // The Forces have Changed
+            wakeBody(jello);
+        }
+
+        free(oldField);
+        delete file;
+        reloaded = 1;
+    }
+
+    // The Timestep may have Changed
+    if (reloaded)
+    {
+        updateTimestep(scene);
+    }
+
+    return reloaded;
+}
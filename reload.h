@@ -0,0 +1,24 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _RELOAD_H_
+#define _RELOAD_H_
+
+// watches the world files of the scene (inotify, Linux only) and reparses
+// them on a background thread whenever they are saved
+// keepState = 1 keeps the current positions and velocities of the bodies,
+// 0 resets them to the ones in the file
+void startReload(struct scene * scene, int keepState);
+
+// swaps the reloaded world files into their bodies: parameters, integrator,
+// timestep and force field, and the positions and velocities unless they are
+// kept. Called by the physics thread between steps.
+// returns 1 if any body was reloaded, 0 otherwise
+int applyReload(struct scene * scene);
+
+#endif
+
@@ -0,0 +1,236 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#define GL_GLEXT_PROTOTYPES
+#include "jello.h"
+#include "renderer.h"
+#include <vector>
+#include <cstddef>
+
+// Vertex of a Cube Face, interleaved in the Vertex Buffer
+struct faceVertex
+{
+    GLfloat position[3];
+    GLfloat normal[3];
+};
+
+// Index Buffers, shared by every Cube
+static GLuint surfacePoints, structuralLines, shearLines, bendLines, faceTriangles;
+static GLsizei surfacePointCount, structuralLineCount, shearLineCount, bendLineCount;
+
+// Vertex Buffer of the Bounding Box
+static GLuint boundingBox;
+static GLsizei boundingBoxCount;
+
+// Vertex Buffers of every Cube, the mass points for the wireframe
+// and the face vertices for the triangles
+static std::vector<GLuint> pointBuffers, faceBuffers;
+
+/**
+ * uploadIndices - Creates a Static Index Buffer
+ */
+static GLuint uploadIndices(const std::vector<GLushort> & indices)
+{
+    GLuint buffer;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0], GL_STATIC_DRAW);
+
+    return buffer;
+}
+
+/**
+ * buildBoundingBox - Builds the Vertex Buffer of the
+ *                    Lines of the Bounding Box
+ */
+static void buildBoundingBox()
+{
+    std::vector<GLfloat> lines;
+
+#define BOX_LINE(x1,y1,z1,x2,y2,z2)\
+    {\
+        GLfloat line[6] = { (GLfloat)(x1), (GLfloat)(y1), (GLfloat)(z1), (GLfloat)(x2), (GLfloat)(y2), (GLfloat)(z2) };\
+        lines.insert(lines.end(), line, line + 6);\
+    }
+
+    for (int i=-2; i<=2; i++) BOX_LINE(i,-2,-2, i,-2,2);  // front face
+    for (int j=-2; j<=2; j++) BOX_LINE(-2,-2,j, 2,-2,j);
+    for (int i=-2; i<=2; i++) BOX_LINE(i,2,-2, i,2,2);    // back face
+    for (int j=-2; j<=2; j++) BOX_LINE(-2,2,j, 2,2,j);
+    for (int i=-2; i<=2; i++) BOX_LINE(-2,i,-2, -2,i,2);  // left face
+    for (int j=-2; j<=2; j++) BOX_LINE(-2,-2,j, -2,2,j);
+    for (int i=-2; i<=2; i++) BOX_LINE(2,i,-2, 2,i,2);    // right face
+    for (int j=-2; j<=2; j++) BOX_LINE(2,-2,j, 2,2,j);
+
+#undef BOX_LINE
+
+    glGenBuffers(1, &boundingBox);
+    glBindBuffer(GL_ARRAY_BUFFER, boundingBox);
+    glBufferData(GL_ARRAY_BUFFER, lines.size() * sizeof(GLfloat), &lines[0], GL_STATIC_DRAW);
+    boundingBoxCount = lines.size() / 3;
+}
+
+/**
+ * startRenderer - Builds the Static Buffers, and the
+ *                 Vertex Buffers of every Cube
+ */
+void startRenderer(int bodies)
+{
+    // Surface Points and Springs of the Wireframe
+    surfacePoints = uploadIndices(std::vector<GLushort>(surface.wirePoint, surface.wirePoint + SURFACE_VERTICES));
+    structuralLines = uploadIndices(surface.structuralLines);
+    shearLines = uploadIndices(surface.shearLines);
+    bendLines = uploadIndices(surface.bendLines);
+    surfacePointCount = SURFACE_VERTICES;
+    structuralLineCount = surface.structuralLines.size();
+    shearLineCount = surface.shearLines.size();
+    bendLineCount = surface.bendLines.size();
+
+    // Triangles of the Faces
+    faceTriangles = uploadIndices(std::vector<GLushort>(&surface.faceTriangle[0][0], &surface.faceTriangle[0][0] + 3 * SURFACE_TRIANGLES));
+
+    buildBoundingBox();
+
+    // Vertex Buffers of the Cubes, refilled every Frame
+    pointBuffers.resize(bodies);
+    faceBuffers.resize(bodies);
+    glGenBuffers(bodies, &pointBuffers[0]);
+    glGenBuffers(bodies, &faceBuffers[0]);
+
+    for (int b=0; b<bodies; b++)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, pointBuffers[b]);
+        glBufferData(GL_ARRAY_BUFFER, 512 * 3 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, faceBuffers[b]);
+        glBufferData(GL_ARRAY_BUFFER, FACE_VERTICES * sizeof(struct faceVertex), NULL, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/**
+ * drawIndices - Draws the Vertices of an Index Buffer
+ */
+static void drawIndices(GLenum mode, GLuint buffer, GLsizei count)
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    glDrawElements(mode, count, GL_UNSIGNED_SHORT, 0);
+}
+
+/**
+ * renderCube - Uploads the Positions (and Normals) of a
+ *              Cube and Draws it from the Static Indices
+ */
+void renderCube(int body, const struct point p[8][8][8], const struct point normal[FACE_VERTICES])
+{
+    if (fabs(p[0][0][0].x) > 10)
+    {
+        printf ("Your cube somehow escaped way out of the box.\n");
+        exit(0);
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    if (viewingMode==0) // render wireframe
+    {
+        // Upload the Positions of the Mass Points
+        static GLfloat position[512][3];
+        const struct point * node = &p[0][0][0];
+        for (int n=0; n<512; n++)
+        {
+            position[n][0] = node[n].x;
+            position[n][1] = node[n].y;
+            position[n][2] = node[n].z;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, pointBuffers[body]);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(position), position);
+        glVertexPointer(3, GL_FLOAT, 0, 0);
+
+        glLineWidth(1);
+        glPointSize(5);
+        glDisable(GL_LIGHTING);
+
+        glColor4f(0.8,0.8,0.8,1.0);
+        drawIndices(GL_POINTS, surfacePoints, surfacePointCount);
+
+        if (structural == 1)
+        {
+            glColor4f(0,0,1,1);
+            drawIndices(GL_LINES, structuralLines, structuralLineCount);
+        }
+
+        if (shear == 1)
+        {
+            glColor4f(0,1,0,1);
+            drawIndices(GL_LINES, shearLines, shearLineCount);
+        }
+
+        if (bend == 1)
+        {
+            glColor4f(1,0,0,1);
+            drawIndices(GL_LINES, bendLines, bendLineCount);
+        }
+
+        glEnable(GL_LIGHTING);
+    }
+    else
+    {
+        // Upload the Positions and Normals of the Face Vertices
+        static struct faceVertex vertex[FACE_VERTICES];
+        const struct point * node = &p[0][0][0];
+        for (int v=0; v<FACE_VERTICES; v++)
+        {
+            const struct point & position = node[surface.faceNode[v]];
+
+            vertex[v].position[0] = position.x;
+            vertex[v].position[1] = position.y;
+            vertex[v].position[2] = position.z;
+            vertex[v].normal[0] = normal[v].x;
+            vertex[v].normal[1] = normal[v].y;
+            vertex[v].normal[2] = normal[v].z;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, faceBuffers[body]);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertex), vertex);
+        glVertexPointer(3, GL_FLOAT, sizeof(struct faceVertex), (GLvoid *) offsetof(struct faceVertex, position));
+        glNormalPointer(GL_FLOAT, sizeof(struct faceVertex), (GLvoid *) offsetof(struct faceVertex, normal));
+        glEnableClientState(GL_NORMAL_ARRAY);
+
+        glPolygonMode(GL_FRONT, GL_FILL);
+        glFrontFace(GL_CCW);
+        drawIndices(GL_TRIANGLES, faceTriangles, SURFACE_TRIANGLES * 3);
+
+        glDisableClientState(GL_NORMAL_ARRAY);
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/**
+ * renderBoundingBox - Draws the Static Lines of the
+ *                     Bounding Box
+ */
+void renderBoundingBox()
+{
+    glColor4f(0.8,0.8,0.8,0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, boundingBox);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+
+    glDrawArrays(GL_LINES, 0, boundingBoxCount);
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
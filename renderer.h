@@ -0,0 +1,27 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _RENDERER_H_
+#define _RENDERER_H_
+
+#include "surfaceMesh.h"
+
+// builds the vertex and index buffers of the cubes and the bounding box
+// (needs a current OpenGL context). The index data and the bounding box
+// are uploaded once, every frame only uploads the positions and normals.
+void startRenderer(int bodies);
+
+// renders body 'body' from the positions of its 512 control points and the
+// normals of its face vertices (see computeFaceNormals), like showCube, from
+// the vertex buffers
+void renderCube(int body, const struct point p[8][8][8], const struct point normal[FACE_VERTICES]);
+
+// renders the bounding box, like showBoundingBox, from its vertex buffer
+void renderBoundingBox();
+
+#endif
+
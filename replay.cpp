@@ -0,0 +1,475 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "replay.h"
+#include "trajectory.h"
+#include "deltaCodec.h"
+#include "simulation.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+// Recorded Trajectory Mapped into Memory
+struct replayFile
+{
+    const unsigned char * base;
+    size_t length;
+    struct trajectoryHeader header;
+    size_t valuesPerBody;           // positions (and velocities) x y z of a body
+    std::vector<int64_t> offsets;   // file offset of every frame
+    int64_t firstStep, lastStep;    // timesteps of the first and the last frame
+
+    // Decoder State of Delta Encoded Trajectories
+    long decoded;                   // frame the quantized values belong to, -1 if none
+    std::vector<long long> quantized;
+
+    // Playback
+    double position;                // timesteps since the first frame, with the fraction of a timestep
+    double lastUpdate;              // wall-clock time the position was last advanced
+};
+
+static struct replayFile * replay = NULL;
+
+/**
+ * frameAt - Copies out the Header of a Frame (delta encoded frames are
+ *           not aligned), and Returns its Values, or NULL if they run
+ *           past the End of the File
+ */
+static const unsigned char * frameAt(int64_t offset, struct trajectoryFrame * frame)
+{
+    if ((offset < 0) || ((size_t) offset + sizeof(struct trajectoryFrame) > replay->length))
+    {
+        return NULL;
+    }
+
+    memcpy(frame, replay->base + offset, sizeof(struct trajectoryFrame));
+    if ((memcmp(frame->tag, "FRME", 4) != 0) ||
+        ((size_t) offset + sizeof(struct trajectoryFrame) + frame->size > replay->length))
+    {
+        return NULL;
+    }
+
+    return replay->base + offset + sizeof(struct trajectoryFrame);
+}
+
+/**
+ * stepOf - Timesteps Performed at a Frame (past the End if it is Unreadable)
+ */
+static int64_t stepOf(long frame)
+{
+    struct trajectoryFrame chunk;
+    if (frameAt(replay->offsets[frame], &chunk) == NULL)
+    {
+        return INT64_MAX;
+    }
+
+    return chunk.step;
+}
+
+/**
+ * readIndex - Takes the Frame Offsets from the Index at the End of
+ *             the File, or finds them by Walking the Frames if the
+ *             Recording was Cut off
+ */
+static void readIndex(size_t framesStart)
+{
+    struct trajectoryEnd end;
+    if (replay->length >= framesStart + sizeof(end))
+    {
+        memcpy(&end, replay->base + replay->length - sizeof(end), sizeof(end));
+
+        size_t indexEnd = replay->length - sizeof(end);
+        if ((memcmp(end.magic, TRAJECTORY_END_MAGIC, 8) == 0) && (end.index >= (int64_t) framesStart) &&
+            ((size_t) end.index + 4 + sizeof(int64_t) <= indexEnd) &&
+            (memcmp(replay->base + end.index, "INDX", 4) == 0))
+        {
+            int64_t frames;
+            memcpy(&frames, replay->base + end.index + 4, sizeof(frames));
+            if ((frames >= 0) && ((size_t) frames == (indexEnd - end.index - 4 - sizeof(int64_t)) / sizeof(int64_t)))
+            {
+                replay->offsets.resize(frames);
+                memcpy(replay->offsets.data(), replay->base + end.index + 4 + sizeof(int64_t), frames * sizeof(int64_t));
+                return;
+            }
+        }
+    }
+
+    // No Index: Walk the Frames up to the Last Whole one
+    printf("No index in the trajectory, walking its frames\n");
+    int64_t offset = framesStart;
+    struct trajectoryFrame frame;
+    while (frameAt(offset, &frame) != NULL)
+    {
+        replay->offsets.push_back(offset);
+        offset += sizeof(struct trajectoryFrame) + frame.size;
+    }
+}
+
+/**
+ * openReplay - Maps a Trajectory and Reads its Header and Index
+ */
+int openReplay(const char * fileName)
+{
+    FILE * file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        printf("Can't read the trajectory %s\n", fileName);
+        return 0;
+    }
+
+    struct stat status;
+    if ((fstat(fileno(file), &status) != 0) || ((size_t) status.st_size < sizeof(struct trajectoryHeader)))
+    {
+        printf("%s is not a trajectory, too short\n", fileName);
+        fclose(file);
+        return 0;
+    }
+
+    size_t length = status.st_size;
+    void * base = mmap(NULL, length, PROT_READ, MAP_SHARED, fileno(file), 0);
+    fclose(file);
+    if (base == MAP_FAILED)
+    {
+        printf("Can't map the trajectory %s\n", fileName);
+        return 0;
+    }
+
+    replay = new replayFile();
+    replay->base = (const unsigned char *) base;
+    replay->length = length;
+    memcpy(&replay->header, base, sizeof(replay->header));
+
+    const struct trajectoryHeader & header = replay->header;
+    if ((memcmp(header.magic, TRAJECTORY_MAGIC, 8) != 0) || (header.version != TRAJECTORY_VERSION) ||
+        (header.bodies <= 0) || (header.encoding < TRAJECTORY_DOUBLE) || (header.encoding > TRAJECTORY_DELTA) ||
+        (header.dt <= 0.0) || (header.n <= 0))
+    {
+        printf("%s is not a trajectory, bad header\n", fileName);
+        munmap(base, length);
+        delete replay;
+        replay = NULL;
+        return 0;
+    }
+
+    // Skip the Static Parameters and Force Fields of the Bodies
+    size_t offset = sizeof(struct trajectoryHeader);
+    for (int b=0; b<header.bodies; b++)
+    {
+        struct trajectoryBody body;
+        if (offset + sizeof(body) > length)
+        {
+            break;
+        }
+        memcpy(&body, replay->base + offset, sizeof(body));
+
+        size_t resolution = (body.resolution > 0) ? body.resolution : 0;
+        offset += sizeof(body) + resolution * resolution * resolution * sizeof(struct point);
+    }
+
+    replay->valuesPerBody = 3 * 512 * (header.velocities ? 2 : 1);
+    replay->decoded = -1;
+    replay->quantized.resize(replay->valuesPerBody * header.bodies);
+    replay->position = 0.0;
+    replay->lastUpdate = wallClock();
+
+    if (offset <= length)
+    {
+        readIndex(offset);
+    }
+
+    if (replay->offsets.empty())
+    {
+        printf("No frames in the trajectory %s\n", fileName);
+        munmap(base, length);
+        delete replay;
+        replay = NULL;
+        return 0;
+    }
+
+    // Frames are Found by their Timestep, a Reload Records a Second Frame at the same one
+    replay->firstStep = stepOf(0);
+    replay->lastStep = stepOf(replay->offsets.size() - 1);
+    if ((replay->firstStep == INT64_MAX) || (replay->lastStep < replay->firstStep) || (replay->lastStep == INT64_MAX))
+    {
+        printf("%s is not a trajectory, bad frames\n", fileName);
+        munmap(base, length);
+        delete replay;
+        replay = NULL;
+        return 0;
+    }
+
+    printf("Replaying %ld frames (%.3f s) of %d jellos from %s\n", (long) replay->offsets.size(),
+           (replay->lastStep - replay->firstStep + 1) * header.dt, header.bodies, fileName);
+
+    return 1;
+}
+
+/**
+ * replayBodies - Number of Jellos in the Replay
+ */
+int replayBodies()
+{
+    return (replay != NULL) ? replay->header.bodies : 0;
+}
+
+/**
+ * replayFrames - Number of Recorded Frames
+ */
+long replayFrames()
+{
+    return (replay != NULL) ? (long) replay->offsets.size() : 0;
+}
+
+/**
+ * replayFrameAt - Finds the Last Frame Recorded at or before
+ *                 a Timestep, by Bisecting the Frames
+ */
+long replayFrameAt(long step)
+{
+    if ((replay == NULL) || (step < 0) || (replay->firstStep + step > replay->lastStep))
+    {
+        return -1;
+    }
+
+    // The First Frame is at or before it, the one after the Last is past it
+    int64_t target = replay->firstStep + step;
+    long lo = 0;
+    long hi = replayFrames();
+    while (hi - lo > 1)
+    {
+        long middle = lo + (hi - lo) / 2;
+        if (stepOf(middle) <= target)
+        {
+            lo = middle;
+        }
+        else
+        {
+            hi = middle;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * replaySteps - Timesteps from the First to the Last Frame, plus one
+ */
+static long replaySteps()
+{
+    return (long) (replay->lastStep - replay->firstStep + 1);
+}
+
+/**
+ * replayTimestep - Timestep of the Recording
+ */
+double replayTimestep()
+{
+    return (replay != NULL) ? replay->header.dt : 0.0;
+}
+
+/**
+ * replayStride - Timesteps per Rendered Frame
+ */
+int replayStride()
+{
+    return (replay != NULL) ? replay->header.n : 1;
+}
+
+/**
+ * decodeDeltas - Applies the Values of a Delta Encoded Frame
+ *                to the Quantized Values
+ *
+ * @return - Returns false on a Truncated Frame
+ */
+static bool decodeDeltas(const struct trajectoryFrame & frame, const unsigned char * values)
+{
+    const unsigned char * in = values;
+    const unsigned char * end = in + frame.size;
+    long long * quantized = replay->quantized.data();
+    size_t count = replay->quantized.size();
+
+    for (size_t i=0; i<count; i++)
+    {
+        unsigned long long value;
+        if ((in = getVarint(in, end, &value)) == NULL)
+        {
+            return false;
+        }
+
+        quantized[i] = unzigzag(value) + (frame.keyframe ? 0 : quantized[i]);
+    }
+
+    return true;
+}
+
+/**
+ * replayFrame - Decodes the Positions of a Recorded Frame
+ */
+bool replayFrame(long frame, std::vector<struct point> & positions)
+{
+    if ((replay == NULL) || (frame < 0) || (frame >= replayFrames()))
+    {
+        return false;
+    }
+
+    const struct trajectoryHeader & header = replay->header;
+    positions.resize(512 * header.bodies);
+
+    struct trajectoryFrame chunk;
+    const unsigned char * values = frameAt(replay->offsets[frame], &chunk);
+    if (values == NULL)
+    {
+        return false;
+    }
+
+    if (header.encoding == TRAJECTORY_DOUBLE)
+    {
+        if (chunk.size < replay->valuesPerBody * header.bodies * sizeof(double))
+        {
+            return false;
+        }
+
+        for (int b=0; b<header.bodies; b++)
+        {
+            memcpy(&positions[512 * b], values + replay->valuesPerBody * b * sizeof(double), 512 * sizeof(struct point));
+        }
+        return true;
+    }
+
+    if (header.encoding == TRAJECTORY_FLOAT)
+    {
+        if (chunk.size < replay->valuesPerBody * header.bodies * sizeof(float))
+        {
+            return false;
+        }
+
+        for (int b=0; b<header.bodies; b++)
+        {
+            const float * in = (const float *) (values + replay->valuesPerBody * b * sizeof(float));
+            double * out = &positions[512 * b].x;
+            for (int i=0; i<3 * 512; i++)
+            {
+                out[i] = in[i];
+            }
+        }
+        return true;
+    }
+
+    // Delta: Decode from the Keyframe before the Frame, or Continue
+    // from the Last Decoded Frame if it is on the Way
+    if (replay->decoded != frame)
+    {
+        long start = frame;
+        for (;;)
+        {
+            if ((replay->decoded >= 0) && (start == replay->decoded + 1))
+            {
+                break;
+            }
+
+            struct trajectoryFrame candidate;
+            if ((frameAt(replay->offsets[start], &candidate) == NULL) || candidate.keyframe || (start == 0))
+            {
+                break;
+            }
+            start--;
+        }
+
+        for (long f=start; f<=frame; f++)
+        {
+            struct trajectoryFrame decoded;
+            const unsigned char * deltas = frameAt(replay->offsets[f], &decoded);
+            if ((deltas == NULL) || !decodeDeltas(decoded, deltas))
+            {
+                replay->decoded = -1;
+                return false;
+            }
+            replay->decoded = f;
+        }
+    }
+
+    for (int b=0; b<header.bodies; b++)
+    {
+        const long long * in = &replay->quantized[replay->valuesPerBody * b];
+        double * out = &positions[512 * b].x;
+        for (int i=0; i<3 * 512; i++)
+        {
+            out[i] = in[i] * header.quantum;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * showReplay - Advances the Playback and Decodes the Frame to Show
+ */
+void showReplay(std::vector<struct point> & positions)
+{
+    if (replay == NULL)
+    {
+        return;
+    }
+
+    // Follow the Wall Clock unless Paused
+    double now = wallClock();
+    if (pause == 0)
+    {
+        replay->position += (now - replay->lastUpdate) / replay->header.dt;
+    }
+    replay->lastUpdate = now;
+
+    // Loop at the End
+    double steps = replaySteps();
+    if (replay->position >= steps)
+    {
+        replay->position = fmod(replay->position, steps);
+    }
+
+    replayFrame(replayFrameAt((long) replay->position), positions);
+}
+
+/**
+ * stepReplay - Moves the Playback by Rendered Frames
+ */
+void stepReplay(long frames)
+{
+    if (replay == NULL)
+    {
+        return;
+    }
+
+    double position = floor(replay->position) + (double) frames * replay->header.n;
+    replay->position = std::max(0.0, std::min(position, (double) (replaySteps() - 1)));
+}
+
+/**
+ * scrubReplay - Moves the Playback by Simulated Time
+ */
+void scrubReplay(double seconds)
+{
+    if (replay == NULL)
+    {
+        return;
+    }
+
+    double position = replay->position + seconds / replay->header.dt;
+    replay->position = std::max(0.0, std::min(position, (double) (replaySteps() - 1)));
+}
+
+/**
+ * rewindReplay - Jumps back to the First Frame
+ */
+void rewindReplay()
+{
+    if (replay != NULL)
+    {
+        replay->position = 0.0;
+    }
+}
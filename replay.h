@@ -0,0 +1,50 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#include <vector>
+
+// opens a trajectory written by the recorder (see trajectory.h) for playback.
+// The file is mapped into memory, not read, so it can be larger than the RAM.
+// A recording that was cut off (no index) is played up to its last whole frame.
+// Returns 0 if it can't be read.
+int openReplay(const char * fileName);
+
+// number of jellos, recorded frames (one per timestep, and one more at every
+// world file reload), timestep, and timesteps per rendered frame
+int replayBodies();
+long replayFrames();
+double replayTimestep();
+int replayStride();
+
+// returns the frame showing the state 'step' timesteps after the first frame:
+// the last one recorded at or before it (after a reload, the reloaded state).
+// Returns -1 past the last frame.
+long replayFrameAt(long step);
+
+// decodes the positions of recorded frame 'frame' into 'positions' (512 per body).
+// Delta encoded frames are decoded from the keyframe before them, or from the last
+// decoded frame when that is closer, so playing forward decodes one frame per frame.
+bool replayFrame(long frame, std::vector<struct point> & positions);
+
+// advances the playback with the wall clock (unless paused), looping at the
+// end, and decodes the frame to show now into 'positions'
+void showReplay(std::vector<struct point> & positions);
+
+// moves the playback by 'frames' rendered frames (n timesteps each), or by
+// 'seconds' of simulated time, held at the ends (the playback follows the
+// recorded timesteps, not the frame numbers)
+void stepReplay(long frames);
+void scrubReplay(double seconds);
+
+// jumps back to the first frame
+void rewindReplay();
+
+#endif
+
@@ -0,0 +1,417 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "physics.h"
+#include "surfaceMesh.h"
+#include "threadPool.h"
+#include <algorithm>
+
+// Broadphase Constants
+const double BOUNDS_MARGIN = 0.25 * (1.0/7.0); // padding of the bounding boxes (the contact thickness)
+
+// Continuous Collision Constants
+const double CCD_REPORT_INTERVAL = 1.0; // simulated time between two continuous collision reports
+
+// Sleep Constants
+const double SLEEP_KINETIC_ENERGY = 1e-5; // kinetic energy per unit mass below which a body is at rest
+const double SLEEP_VELOCITY = 0.05;       // speed every mass point must stay below for a body to be at rest
+const double SLEEP_TIME = 0.25;           // time a body has to stay at rest before it is put to sleep
+
+struct scene jelloScene;
+
+/**
+ * addBody - Adds a Jello to the Scene
+ */
+void addBody(struct scene * scene, struct world * jello, const char * fileName, struct point offset)
+{
+    // Add the Body
+    scene->bodies.push_back(jello);
+    scene->files.push_back(fileName);
+    scene->offsets.push_back(offset);
+    scene->order.push_back(scene->bodies.size() - 1);
+    scene->lo.resize(scene->bodies.size());
+    scene->hi.resize(scene->bodies.size());
+
+    updateTimestep(scene);
+}
+
+/**
+ * updateTimestep - Steps every Body with the Smallest
+ *                  Timestep of all the Bodies
+ */
+void updateTimestep(struct scene * scene)
+{
+    scene->dt = scene->bodies[0]->dt;
+    scene->n = scene->bodies[0]->n;
+
+    // The Smallest Timestep of all the Bodies is used by the Scene
+    // Render as often as the Body that asks for it most often
+    for (size_t b=1; b<scene->bodies.size(); b++)
+    {
+        scene->dt = std::min(scene->dt, scene->bodies[b]->dt);
+        scene->n = std::min(scene->n, scene->bodies[b]->n);
+    }
+
+    // Step every Body with the Common Timestep
+    for (size_t b=0; b<scene->bodies.size(); b++)
+    {
+        if (scene->bodies[b]->dt != scene->dt)
+        {
+            printf("Body %d: timestep %lf lowered to %lf\n", (int)b, scene->bodies[b]->dt, scene->dt);
+            scene->bodies[b]->dt = scene->dt;
+        }
+    }
+}
+
+/**
+ * updateBounds - Computes the Bounding Box of the
+ *                Surface Vertices of a Body
+ */
+static void updateBounds(struct scene * scene, int b)
+{
+    struct world * jello = scene->bodies[b];
+    point lo = jello->p[0][0][0];
+    point hi = jello->p[0][0][0];
+
+    // Iterate over the Surface Vertices
+    for (int s=1; s<SURFACE_VERTICES; s++)
+    {
+        point & p = jello->p[surface.vertex[s][0]][surface.vertex[s][1]][surface.vertex[s][2]];
+
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+        hi.z = std::max(hi.z, p.z);
+    }
+
+    // Pad by the Contact Thickness
+    scene->lo[b].x = lo.x - BOUNDS_MARGIN;
+    scene->lo[b].y = lo.y - BOUNDS_MARGIN;
+    scene->lo[b].z = lo.z - BOUNDS_MARGIN;
+    scene->hi[b].x = hi.x + BOUNDS_MARGIN;
+    scene->hi[b].y = hi.y + BOUNDS_MARGIN;
+    scene->hi[b].z = hi.z + BOUNDS_MARGIN;
+}
+
+/**
+ * sweepAndPrune - Finds the Pairs of Bodies whose
+ *                 Bounding Boxes overlap
+ */
+static void sweepAndPrune(struct scene * scene)
+{
+    std::vector<int> & order = scene->order;
+    int count = order.size();
+
+    // Keep the Bodies sorted by the Left Side of their Bounding Box
+    // (insertion sort, as the order barely changes between steps)
+    for (int i=1; i<count; i++)
+    {
+        int body = order[i];
+        int j = i - 1;
+
+        while ((j >= 0) && (scene->lo[order[j]].x > scene->lo[body].x))
+        {
+            order[j+1] = order[j];
+            j--;
+        }
+        order[j+1] = body;
+    }
+
+    scene->pairs.clear();
+
+    // Sweep along X, only Bodies starting before the current one ends can overlap it
+    for (int i=0; i<count; i++)
+    {
+        int a = order[i];
+
+        for (int j=i+1; (j < count) && (scene->lo[order[j]].x <= scene->hi[a].x); j++)
+        {
+            int b = order[j];
+
+            // Check the Overlap along Y and Z
+            if ((scene->lo[a].y <= scene->hi[b].y) && (scene->lo[b].y <= scene->hi[a].y) &&
+                (scene->lo[a].z <= scene->hi[b].z) && (scene->lo[b].z <= scene->hi[a].z))
+            {
+                scene->pairs.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+            }
+        }
+    }
+}
+
+/**
+ * processBodyContacts - Computes the Contact Forces between
+ *                       the Bodies for the next Timestep
+ */
+static void processBodyContacts(struct scene * scene)
+{
+    int count = scene->bodies.size();
+
+    // Update the Spatial Hashes and Bounding Boxes
+    // (sleeping bodies do not move, theirs are still current)
+    parallelFor(count, 1, [&](int begin, int end)
+    {
+        for (int b=begin; b<end; b++)
+        {
+            if (!scene->bodies[b]->asleep)
+            {
+                updateSpatialHash(scene->bodies[b]);
+                updateBounds(scene, b);
+            }
+        }
+    });
+
+    // Broadphase
+    sweepAndPrune(scene);
+
+    // Narrowphase of every Candidate Pair
+    int pairs = scene->pairs.size();
+    scene->contacts.resize(pairs);
+
+    parallelFor(pairs, 1, [&](int begin, int end)
+    {
+        for (int n=begin; n<end; n++)
+        {
+            struct world * a = scene->bodies[scene->pairs[n].first];
+            struct world * b = scene->bodies[scene->pairs[n].second];
+
+            // Sleeping Bodies cannot push each other
+            if (a->asleep && b->asleep)
+            {
+                scene->contacts[n].clear();
+                continue;
+            }
+
+            findBodyContacts(a, b, scene->contacts[n]);
+        }
+    });
+
+    // Reset the Contact Forces (the Multi-Rate Slow Accelerations of a
+    // Body that was in Contact hold the old ones)
+    for (int b=0; b<count; b++)
+    {
+        if (scene->bodies[b]->inContact)
+        {
+            scene->bodies[b]->slowValid = 0;
+        }
+        scene->bodies[b]->inContact = 0;
+    }
+
+    // Apply the Contacts in Pair Order, so the Result does not depend on the Thread Count
+    for (int n=0; n<pairs; n++)
+    {
+        if (scene->contacts[n].empty())
+        {
+            continue;
+        }
+
+        struct world * a = scene->bodies[scene->pairs[n].first];
+        struct world * b = scene->bodies[scene->pairs[n].second];
+
+        // Wake up Sleeping Bodies hit by a Moving Body
+        // (a body resting on a sleeping one does not wake it)
+        if (a->asleep && (b->restTime == 0.0))
+        {
+            wakeBody(a);
+        }
+        if (b->asleep && (a->restTime == 0.0))
+        {
+            wakeBody(b);
+        }
+
+        // Clear the Contact Forces of Bodies touching for the first time this Step
+        // (and Recompute their Slow Accelerations with the new ones)
+        if (!a->inContact)
+        {
+            memset(a->contactForce, 0, sizeof(a->contactForce));
+            a->inContact = 1;
+            a->slowValid = 0;
+        }
+        if (!b->inContact)
+        {
+            memset(b->contactForce, 0, sizeof(b->contactForce));
+            b->inContact = 1;
+            b->slowValid = 0;
+        }
+
+        applyBodyContacts(a, b, scene->contacts[n]);
+    }
+}
+
+/**
+ * updateRest - Tracks how long a Body has been at Rest,
+ *              and puts it to Sleep once it has been at
+ *              Rest for SLEEP_TIME
+ */
+static void updateRest(struct scene * scene, int b)
+{
+    struct world * jello = scene->bodies[b];
+    double energy = 0.0;
+    double maxSpeed2 = 0.0;
+
+    // Get the Kinetic Energy per Unit Mass and the Fastest Mass Point
+    for (int i=0; i<=7; i++)
+    {
+        for (int j=0; j<=7; j++)
+        {
+            for (int k=0; k<=7; k++)
+            {
+                double speed2;
+                DOTPRODUCTp(jello->v[i][j][k], jello->v[i][j][k], speed2);
+
+                energy += 0.5 * speed2;
+                maxSpeed2 = std::max(maxSpeed2, speed2);
+            }
+        }
+    }
+    energy /= 512;
+
+    // Check the Rest Thresholds
+    if ((energy >= SLEEP_KINETIC_ENERGY) || (maxSpeed2 >= SLEEP_VELOCITY * SLEEP_VELOCITY))
+    {
+        jello->restTime = 0.0;
+        return;
+    }
+
+    jello->restTime += jello->dt;
+
+    // Put the Body to Sleep
+    if (jello->restTime >= SLEEP_TIME)
+    {
+        // Stop the Body completely, so it wakes up from Rest
+        memset(jello->v, 0, sizeof(jello->v));
+        jello->asleep = 1;
+
+        // Freeze its Spatial Hash and Bounding Box at the Final Positions
+        if (scene->bodies.size() > 1)
+        {
+            updateSpatialHash(jello);
+            updateBounds(scene, b);
+        }
+    }
+}
+
+/**
+ * stepScene - Performs one Timestep of every Body in the Scene
+ */
+void stepScene(struct scene * scene)
+{
+    int count = scene->bodies.size();
+
+    // The Key may Toggle Continuous Collision during the Step
+    int ccd = continuousCollision;
+
+    // Compute the Contact Forces between the Bodies
+    if (count > 1)
+    {
+        processBodyContacts(scene);
+    }
+
+    // Integrate the Bodies on the Shared Workers
+    // (one body per chunk, so the workers balance uneven bodies)
+    parallelFor(count, 1, [&](int begin, int end)
+    {
+        for (int b=begin; b<end; b++)
+        {
+            // Sleeping Bodies cost nothing
+            if (scene->bodies[b]->asleep)
+            {
+                scene->bodies[b]->clamped = 0;
+                continue;
+            }
+
+            struct world * jello = scene->bodies[b];
+
+            // Keep the Start of the Step for Continuous Collision
+            point start[8][8][8];
+            if (ccd == 1)
+            {
+                memcpy(start, jello->p, sizeof(start));
+            }
+
+            integrate(jello);
+
+            // Stop the Points that Tunneled into the Walls (the Multi-Rate Slow
+            // Accelerations were computed where they would have been)
+            jello->clamped = 0;
+            if (ccd == 1)
+            {
+                jello->clamped = sweepBoundingBox(jello, start);
+                if (jello->clamped != 0)
+                {
+                    jello->slowValid = 0;
+                }
+            }
+
+            updateRest(scene, b);
+        }
+    });
+
+    // Advance the Simulated Time
+    int report = (int)(scene->time / CCD_REPORT_INTERVAL);
+    scene->time += scene->dt;
+    scene->steps++;
+
+    // Report how often Continuous Collision Triggered
+    if (ccd == 1)
+    {
+        for (int b=0; b<count; b++)
+        {
+            scene->ccdClamped += scene->bodies[b]->clamped;
+        }
+        scene->ccdSteps++;
+
+        if ((int)(scene->time / CCD_REPORT_INTERVAL) != report)
+        {
+            printf("Continuous collision: %d points stopped at the walls in %d steps\n", scene->ccdClamped, scene->ccdSteps);
+            scene->ccdClamped = 0;
+            scene->ccdSteps = 0;
+        }
+    }
+}
+
+/**
+ * wakeBody - Wakes a Sleeping Body up
+ */
+void wakeBody(struct world * jello)
+{
+    jello->asleep = 0;
+    jello->restTime = 0.0;
+    jello->slowValid = 0;
+}
+
+/**
+ * sceneAsleep - Checks if every Body in the Scene is Asleep
+ */
+bool sceneAsleep(struct scene * scene)
+{
+    for (size_t b=0; b<scene->bodies.size(); b++)
+    {
+        if (!scene->bodies[b]->asleep)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * wakeScene - Wakes every Body in the Scene up
+ */
+void wakeScene(struct scene * scene)
+{
+    for (size_t b=0; b<scene->bodies.size(); b++)
+    {
+        wakeBody(scene->bodies[b]);
+    }
+}
+
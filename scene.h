@@ -0,0 +1,62 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _SCENE_H_
+#define _SCENE_H_
+
+#include <vector>
+#include <utility>
+#include <string>
+#include "collision.h"
+
+// Represents all the Jello Cubes sharing the Bounding Box
+struct scene
+{
+  std::vector<struct world *> bodies; // the jello cubes, each with its own parameters
+  std::vector<std::string> files; // world file every body was read from
+  std::vector<struct point> offsets; // offset every body was moved by from its world file
+  double dt; // common timestep of all the bodies (the smallest one in their world files)
+  int n; // timesteps per rendered frame (the smallest one in the world files)
+  double time; // simulated time
+  long steps; // timesteps performed
+
+  int ccdSteps; // timesteps since the last continuous collision report
+  int ccdClamped; // points stopped at the bounding box since the last report
+
+  std::vector<struct point> lo, hi; // bounding box of the surface of every body
+  std::vector<int> order; // bodies sorted by the left side of their bounding box (sweep-and-prune)
+  std::vector<std::pair<int, int> > pairs; // pairs of bodies with overlapping bounding boxes
+  std::vector<std::vector<struct contact> > contacts; // contacts found for every pair
+};
+
+extern struct scene jelloScene;
+
+// adds a jello read from 'fileName' and moved by 'offset' to the scene,
+// the scene does not take ownership
+void addBody(struct scene * scene, struct world * jello, const char * fileName, struct point offset);
+
+// lowers the timestep of every body to the smallest one in the scene,
+// and renders as often as the body asking for it most often
+void updateTimestep(struct scene * scene);
+
+// performs one timestep of every body in the scene, including the contact
+// forces between the bodies. Bodies at rest are put to sleep and skipped.
+// With continuous collision on, reports once per simulated second how
+// many points it had to stop at the bounding box.
+void stepScene(struct scene * scene);
+
+// wakes a sleeping body up, e.g. after its forces have changed
+void wakeBody(struct world * jello);
+
+// wakes every body in the scene up
+void wakeScene(struct scene * scene);
+
+// checks if every body in the scene is asleep
+bool sceneAsleep(struct scene * scene);
+
+#endif
+
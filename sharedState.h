@@ -0,0 +1,188 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _SHAREDSTATE_H_
+#define _SHAREDSTATE_H_
+
+// Layout of the Shared-Memory Segment a running Jello publishes its Frames
+// into (-shm name), and the Client Side for other Processes on the Machine.
+// This header stands alone (no jello.h), so any tool can include it (it includes
+// unistd.h, whose pause() clashes with the one of jello.h, so the simulator only
+// includes it in statePublisher.cpp):
+//
+//   struct sharedStateClient client;
+//   if (openSharedState("/jello", &client))
+//   {
+//       uint32_t ticket;
+//       const struct sharedFrame * frame = beginSharedRead(&client, &ticket);
+//       if (frame != NULL)
+//       {
+//           const double * p = sharedPositions(frame); // read x y z of the points in place
+//           ...
+//           if (!endSharedRead(&client, ticket)) { /* overwritten meanwhile, read again */ }
+//       }
+//       closeSharedState(&client);
+//   }
+//
+// The segment holds two frame buffers behind a sequence counter (a seqlock):
+// the publisher fills the buffer that is not published, with the counter odd,
+// and flips to it by adding 2 more. A reader reads the published buffer in
+// place and checks the counter again; the frame was consistent unless the
+// publisher came back to that buffer meanwhile (counter 3 or more past).
+// Reading takes no copies and no system calls, and never blocks the publisher.
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SHARED_STATE_MAGIC "JELLOSHM"
+#define SHARED_STATE_VERSION 1
+
+// offset of the first frame buffer, and alignment of the frame buffers
+#define SHARED_STATE_ALIGNMENT 64
+
+// the counter has to work between processes
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "shared counters must be plain words");
+
+struct sharedStateHeader
+{
+    char magic[8];                      // SHARED_STATE_MAGIC
+    uint32_t version;                   // SHARED_STATE_VERSION
+    uint32_t bodies;                    // jellos in the scene
+    uint32_t frameBytes;                // bytes of a frame buffer (sharedFrame and positions, aligned)
+    int32_t n;                          // timesteps per published frame
+    double dt;                          // timestep
+    std::atomic<uint32_t> sequence;     // frames published times 2, odd while one is written
+    std::atomic<uint32_t> closed;       // 1 once the publisher stopped
+};
+
+// header of a frame buffer, followed by the positions of the 512 mass
+// points of every body (x y z doubles, in body order, 64 * i + 8 * j + k)
+struct sharedFrame
+{
+    int64_t step;                       // timesteps performed
+    double time;                        // simulated time
+};
+
+// bytes of the whole segment of 'bodies' jellos
+static inline size_t sharedStateSize(uint32_t bodies, uint32_t * frameBytes)
+{
+    size_t bytes = sizeof(struct sharedFrame) + (size_t) bodies * 512 * 3 * sizeof(double);
+    bytes = (bytes + SHARED_STATE_ALIGNMENT - 1) / SHARED_STATE_ALIGNMENT * SHARED_STATE_ALIGNMENT;
+
+    if (frameBytes != NULL)
+    {
+        *frameBytes = (uint32_t) bytes;
+    }
+    return SHARED_STATE_ALIGNMENT + 2 * bytes;
+}
+
+// frame buffer 'buffer' (0 or 1) of the mapped segment
+static inline struct sharedFrame * sharedBuffer(void * base, int buffer)
+{
+    const struct sharedStateHeader * header = (const struct sharedStateHeader *) base;
+    return (struct sharedFrame *) ((char *) base + SHARED_STATE_ALIGNMENT + (size_t) buffer * header->frameBytes);
+}
+
+// positions following the header of a frame
+static inline const double * sharedPositions(const struct sharedFrame * frame)
+{
+    return (const double *) (frame + 1);
+}
+
+// Read-Only Mapping of a Segment in a Client
+struct sharedStateClient
+{
+    void * base;
+    size_t length;
+    const struct sharedStateHeader * header;
+};
+
+// maps the segment 'name' (e.g. "/jello") read-only.
+// Returns 0 if there is none, or it is not from this version.
+static inline int openSharedState(const char * name, struct sharedStateClient * client)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || ((size_t) status.st_size < sizeof(struct sharedStateHeader)))
+    {
+        close(fd);
+        return 0;
+    }
+
+    void * base = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    const struct sharedStateHeader * header = (const struct sharedStateHeader *) base;
+    uint32_t frameBytes;
+    if ((memcmp(header->magic, SHARED_STATE_MAGIC, 8) != 0) || (header->version != SHARED_STATE_VERSION) ||
+        (sharedStateSize(header->bodies, &frameBytes) > (size_t) status.st_size) || (frameBytes != header->frameBytes))
+    {
+        munmap(base, status.st_size);
+        return 0;
+    }
+
+    client->base = base;
+    client->length = status.st_size;
+    client->header = header;
+    return 1;
+}
+
+// unmaps the segment
+static inline void closeSharedState(struct sharedStateClient * client)
+{
+    munmap(client->base, client->length);
+    client->base = NULL;
+    client->header = NULL;
+}
+
+// returns the newest published frame, to be read in place, or NULL if none was
+// published yet. Hand 'ticket' to endSharedRead once done reading.
+static inline const struct sharedFrame * beginSharedRead(const struct sharedStateClient * client, uint32_t * ticket)
+{
+    uint32_t begin = client->header->sequence.load(std::memory_order_acquire);
+    *ticket = begin;
+
+    if (begin < 2)
+    {
+        return NULL;
+    }
+
+    return sharedBuffer(client->base, (begin / 2) % 2);
+}
+
+// checks that the frame from beginSharedRead was not overwritten while it was
+// read. Returns false if it was, then everything read from it is to be dropped.
+static inline bool endSharedRead(const struct sharedStateClient * client, uint32_t ticket)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t end = client->header->sequence.load(std::memory_order_relaxed);
+
+    return end - (ticket & ~1u) < 3;
+}
+
+// checks if the publisher stopped (the last frame stays readable)
+static inline bool sharedStateClosed(const struct sharedStateClient * client)
+{
+    return client->header->closed.load(std::memory_order_acquire) != 0;
+}
+
+#endif
+
@@ -37,7 +37,7 @@ int pointMap(int side, int i, int j)
     return r;
 }
 
-void showCube(struct world * jello)
+void showCube(const struct point p[8][8][8])
 {
     int i,j,k,ip,jp,kp;
     point r1,r2,r3; // aux variables
@@ -49,14 +49,14 @@ void showCube(struct world * jello)
     int face;
     double faceFactor, length;
 
-    if (fabs(jello->p[0][0][0].x) > 10)
+    if (fabs(p[0][0][0].x) > 10)
     {
         printf ("Your cube somehow escaped way out of the box.\n");
         exit(0);
     }
 
 
-#define NODE(face,i,j) (*((struct point * )(jello->p) + pointMap((face),(i),(j))))
+#define NODE(face,i,j) (*((struct point * )(p) + pointMap((face),(i),(j))))
 
 
 #define PROCESS_NEIGHBOUR(di,dj,dk) \
@@ -69,8 +69,8 @@ void showCube(struct world * jello)
 				(kp>7) || (kp<0) ) && ((i==0) || (i==7) || (j==0) || (j==7) || (k==0) || (k==7))\
 				&& ((ip==0) || (ip==7) || (jp==0) || (jp==7) || (kp==0) || (kp==7))) \
 				{\
-			glVertex3f(jello->p[i][j][k].x,jello->p[i][j][k].y,jello->p[i][j][k].z);\
-			glVertex3f(jello->p[ip][jp][kp].x,jello->p[ip][jp][kp].y,jello->p[ip][jp][kp].z);\
+			glVertex3f(p[i][j][k].x,p[i][j][k].y,p[i][j][k].z);\
+			glVertex3f(p[ip][jp][kp].x,p[ip][jp][kp].y,p[ip][jp][kp].z);\
 				}\
 
 
@@ -88,7 +88,7 @@ void showCube(struct world * jello)
 
                     glBegin(GL_POINTS); // draw point
                     glColor4f(0.8,0.8,0.8,1.0);
-                    glVertex3f(jello->p[i][j][k].x,jello->p[i][j][k].y,jello->p[i][j][k].z);
+                    glVertex3f(p[i][j][k].x,p[i][j][k].y,p[i][j][k].z);
                     glEnd();
 
                     //
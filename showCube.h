@@ -9,7 +9,11 @@
 #ifndef _SHOWCUBE_H_
 #define _SHOWCUBE_H_
 
-void showCube(struct world * jello);
+// maps position (i,j) on a face of the cube to the index of its mass point
+int pointMap(int side, int i, int j);
+
+// renders a cube from the positions of its 512 control points
+void showCube(const struct point p[8][8][8]);
 
 void showBoundingBox();
 
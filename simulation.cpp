@@ -0,0 +1,402 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "simulation.h"
+#include "tuning.h"
+#include "reload.h"
+#include "surfaceMesh.h"
+#include "trajectory.h"
+#include "checkpoint.h"
+#include "pointCache.h"
+#include "statePublisher.h"
+#include "streamServer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+// Scheduler Constants
+const double SCHEDULER_MIN_SLEEP = 0.001; // shortest sleep when ahead of the wall clock (seconds)
+const double SCHEDULER_MAX_TICK = 0.05;   // longest time spent catching up before the backlog is dropped (seconds)
+
+struct snapshotRing snapshots;
+
+// Physics Thread State
+static std::thread physicsThread;
+static std::atomic<bool> running(false);
+static std::atomic<bool> wakeRequested(false);
+static std::atomic<bool> still(false); // the physics thread is blocked on a paused or sleeping scene
+
+// Signals the Physics Thread that the User changed something
+static std::mutex requestMutex;
+static std::condition_variable requestReady;
+static std::atomic<int> requests(0); // changed under requestMutex
+
+/**
+ * publishSnapshot - Copies the State of the Scene into the next
+ *                   free Slot of the Ring and publishes it
+ *
+ * @return - Returns false if the Ring is full
+ */
+static bool publishSnapshot(struct snapshotRing * ring, struct scene * scene, double clock)
+{
+    unsigned head = ring->head.load(std::memory_order_relaxed);
+    unsigned tail = ring->tail.load(std::memory_order_acquire);
+
+    // The Slot the Consumer holds is never written
+    if (head - tail >= SNAPSHOT_SLOTS)
+    {
+        return false;
+    }
+
+    // Fill the Slot
+    struct snapshot & s = ring->slot[head % SNAPSHOT_SLOTS];
+    s.time = scene->time;
+    s.step = scene->steps;
+    s.clock = clock;
+
+    for (size_t b=0; b<scene->bodies.size(); b++)
+    {
+        memcpy(&s.p[512 * b], scene->bodies[b]->p, 512 * sizeof(struct point));
+
+        // Shade here, so the Renderer does no Geometry
+        computeFaceNormals(scene->bodies[b]->p, &s.n[FACE_VERTICES * b]);
+    }
+
+    // Publish it
+    ring->head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * publishPositions - Publishes Positions (512 per Jello) to the Shared
+ *                    Memory and the Stream of other Processes
+ */
+void publishPositions(const std::vector<struct point> & positions, long step, double time)
+{
+    double * p = beginPublish();
+    if (p != NULL)
+    {
+        memcpy(p, &positions[0], positions.size() * sizeof(struct point));
+        endPublish(step, time);
+    }
+
+    p = beginStream();
+    if (p != NULL)
+    {
+        memcpy(p, &positions[0], positions.size() * sizeof(struct point));
+        endStream(step, time);
+    }
+}
+
+/**
+ * publishScene - Publishes the Positions of the Scene to the Shared
+ *                Memory and the Stream of other Processes, copying
+ *                every Jello straight into the Published Frames
+ */
+static void publishScene(struct scene * scene)
+{
+    double * p = beginPublish();
+    if (p != NULL)
+    {
+        for (size_t b=0; b<scene->bodies.size(); b++)
+        {
+            memcpy(p + 3 * 512 * b, scene->bodies[b]->p, 512 * sizeof(struct point));
+        }
+
+        endPublish(scene->steps, scene->time);
+    }
+
+    p = beginStream();
+    if (p != NULL)
+    {
+        for (size_t b=0; b<scene->bodies.size(); b++)
+        {
+            memcpy(p + 3 * 512 * b, scene->bodies[b]->p, 512 * sizeof(struct point));
+        }
+
+        endStream(scene->steps, scene->time);
+    }
+}
+
+/**
+ * physicsLoop - Main Loop of the Physics Thread, advancing the
+ *               Simulated Time in Fixed Timesteps to follow
+ *               the Wall Clock
+ */
+static void physicsLoop(struct scene * scene)
+{
+    // Steps since the last Snapshot, and whether one is due
+    int sinceSnapshot = 0;
+    bool due = true;
+    long published = -1;
+
+    // Wall-Clock Time not simulated yet
+    double accumulator = 0.0;
+    double last = wallClock();
+
+    // Other Processes see the Initial State
+    publishScene(scene);
+
+    while (running.load(std::memory_order_acquire))
+    {
+        // Requests seen so far (read before the settings, so none is missed when blocking)
+        int seen = requests.load();
+
+        // Handle Requests from the User Interface
+        if (wakeRequested.exchange(false))
+        {
+            wakeScene(scene);
+        }
+
+        // Take over Parameters Tuned by the User
+        applyTuning(scene);
+
+        // Swap in Reloaded World Files (the Renderer must see a Reset even when Paused)
+        if (applyReload(scene))
+        {
+            due = true;
+            published = -1;
+
+            // The Recording Restarts from the Reloaded State
+            recordScene(scene, true);
+            publishScene(scene);
+        }
+
+        // Take the Checkpoints asked for (also while Paused)
+        checkpointScene(scene);
+
+        // Simulated Time the Scheduler is aiming for, as an Offset to the Wall Clock
+        double now = wallClock();
+        double clock = now - (scene->time + accumulator);
+
+        // Publish the State (retried every tick while the renderer is behind)
+        if (due && publishSnapshot(&snapshots, scene, clock))
+        {
+            due = false;
+            published = scene->steps;
+        }
+
+        // Check if Nothing can Change (Paused, or every Jello at Rest)
+        if ((pause == 1) || sceneAsleep(scene))
+        {
+            // Make sure the Renderer gets the Final State first
+            due = (scene->steps != published);
+            if (due)
+            {
+                std::this_thread::sleep_for(std::chrono::duration<double>(SCHEDULER_MIN_SLEEP));
+                continue;
+            }
+
+            // Block until the User changes something
+            std::unique_lock<std::mutex> lock(requestMutex);
+            still = true;
+            requestReady.wait(lock, [&] { return (requests != seen) || !running.load(); });
+            still = false;
+            lock.unlock();
+
+            // Time spent Still is not Simulated
+            last = wallClock();
+            continue;
+        }
+
+        // Accumulate the Wall-Clock Time since the last Tick
+        accumulator += now - last;
+        last = now;
+
+        // Sleep when Ahead of the Wall Clock
+        if (accumulator < scene->dt)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::max(scene->dt - accumulator, SCHEDULER_MIN_SLEEP)));
+            continue;
+        }
+
+        // Catch up in Fixed Timesteps
+        while (accumulator >= scene->dt)
+        {
+            // Perform one Step of every Jello (with the Newest Parameters)
+            applyTuning(scene);
+            stepScene(scene);
+            recordScene(scene, false);
+            checkpointScene(scene);
+            accumulator -= scene->dt;
+
+            // Display only every nth Timepoint
+            if (++sinceSnapshot >= scene->n)
+            {
+                sinceSnapshot = 0;
+                due = true;
+
+                // Export the Surface at the Rendered Frames
+                exportScene(scene);
+                publishScene(scene);
+
+                if (publishSnapshot(&snapshots, scene, clock))
+                {
+                    due = false;
+                    published = scene->steps;
+                }
+            }
+
+            // Drop the Backlog instead of Spiraling when the Physics can't keep up
+            if (wallClock() - now > SCHEDULER_MAX_TICK)
+            {
+                accumulator = 0.0;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * startSimulation - Starts the Physics Thread
+ */
+void startSimulation(struct scene * scene)
+{
+    // Allocate the Snapshots once
+    for (int i=0; i<SNAPSHOT_SLOTS; i++)
+    {
+        snapshots.slot[i].p.resize(512 * scene->bodies.size());
+        snapshots.slot[i].n.resize(FACE_VERTICES * scene->bodies.size());
+    }
+    snapshots.head = 0;
+    snapshots.tail = 0;
+
+    // Start the Thread
+    running = true;
+    physicsThread = std::thread(physicsLoop, scene);
+
+    // Stop it before the Scene is destroyed at Exit
+    atexit(stopSimulation);
+}
+
+/**
+ * stopSimulation - Stops the Physics Thread
+ */
+void stopSimulation()
+{
+    running = false;
+    notifySimulation();
+
+    if (physicsThread.joinable() && (physicsThread.get_id() != std::this_thread::get_id()))
+    {
+        physicsThread.join();
+    }
+}
+
+/**
+ * acquireSnapshot - Returns the two Newest Snapshots, releasing the Older ones
+ */
+const struct snapshot * acquireSnapshot(struct snapshotRing * ring, const struct snapshot ** previous)
+{
+    unsigned head = ring->head.load(std::memory_order_acquire);
+
+    // Nothing Published yet
+    if (head == 0)
+    {
+        *previous = NULL;
+        return NULL;
+    }
+
+    // Only the Initial State
+    if (head == 1)
+    {
+        *previous = NULL;
+        return &ring->slot[0];
+    }
+
+    // Hold the two Newest Snapshots, the Producer may reuse all the Others
+    ring->tail.store(head - 2, std::memory_order_release);
+
+    *previous = &ring->slot[(head - 2) % SNAPSHOT_SLOTS];
+    return &ring->slot[(head - 1) % SNAPSHOT_SLOTS];
+}
+
+/**
+ * blendPoints - Blends two Arrays of Points with the Weight
+ *               'alpha' of the Newest
+ */
+static void blendPoints(const std::vector<struct point> & previous, const std::vector<struct point> & newest,
+                        double alpha, std::vector<struct point> & p)
+{
+    p.resize(newest.size());
+
+    for (size_t i=0; i<p.size(); i++)
+    {
+        p[i].x = previous[i].x + alpha * (newest[i].x - previous[i].x);
+        p[i].y = previous[i].y + alpha * (newest[i].y - previous[i].y);
+        p[i].z = previous[i].z + alpha * (newest[i].z - previous[i].z);
+    }
+}
+
+/**
+ * interpolateSnapshots - Blends the two Newest Snapshots at the
+ *                        Current Wall-Clock Time
+ */
+void interpolateSnapshots(const struct snapshot * previous, const struct snapshot * newest,
+                          std::vector<struct point> & p, std::vector<struct point> & n)
+{
+    // Nothing to Blend with
+    if ((previous == NULL) || (newest->time <= previous->time))
+    {
+        p = newest->p;
+        n = newest->n;
+        return;
+    }
+
+    // Render one Snapshot Interval in the Past, so the Time falls between the two
+    double interval = newest->time - previous->time;
+    double time = (wallClock() - newest->clock) - interval;
+
+    // Interpolation Weight of the Newest Snapshot (held at the ends, never extrapolated)
+    double alpha = (time - previous->time) / interval;
+    alpha = std::max(0.0, std::min(alpha, 1.0));
+
+    blendPoints(previous->p, newest->p, alpha, p);
+    blendPoints(previous->n, newest->n, alpha, n);
+}
+
+/**
+ * wallClock - Wall-Clock Time in Seconds
+ */
+double wallClock()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * requestWake - Asks the Physics Thread to wake the Scene up
+ */
+void requestWake()
+{
+    wakeRequested = true;
+    notifySimulation();
+}
+
+/**
+ * notifySimulation - Unblocks the Physics Thread to recheck the User Settings
+ */
+void notifySimulation()
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    requests++;
+    requestReady.notify_all();
+}
+
+/**
+ * simulationStill - Checks if the Physics Thread is Blocked
+ *                   on a Paused or Sleeping Scene
+ */
+bool simulationStill()
+{
+    return still.load();
+}
@@ -0,0 +1,77 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _SIMULATION_H_
+#define _SIMULATION_H_
+
+#include <vector>
+#include <atomic>
+
+// number of snapshots in the ring between the physics thread and the renderer
+#define SNAPSHOT_SLOTS 8
+
+// Represents the State of the Scene after a Timestep,
+// published by the physics thread for rendering
+struct snapshot
+{
+    double time; // simulated time
+    long step; // timesteps performed
+    double clock; // wall-clock time minus the simulated time the scheduler is aiming for
+    std::vector<struct point> p; // positions of the 512 control points of every body, in body order
+    std::vector<struct point> n; // Gouraud normals of the FACE_VERTICES face vertices of every body, in body order
+};
+
+// Single-producer/single-consumer lock-free ring of snapshots
+// the physics thread writes the slots, the renderer reads them
+struct snapshotRing
+{
+    struct snapshot slot[SNAPSHOT_SLOTS];
+    std::atomic<unsigned> head; // snapshots published so far (written by the producer only)
+    std::atomic<unsigned> tail; // snapshot held by the consumer, older ones are free (written by the consumer only)
+};
+
+extern struct snapshotRing snapshots;
+
+// starts the physics thread stepping the scene in real time. It runs as many
+// timesteps as the wall clock asks for, sleeps when ahead, and publishes a
+// snapshot every n steps (the smallest n of the world files) without ever
+// waiting for the renderer. While the scene is paused or asleep it blocks
+// until notified.
+void startSimulation(struct scene * scene);
+
+// stops and joins the physics thread (also registered with atexit)
+void stopSimulation();
+
+// returns the newest published snapshot, or NULL if nothing was published yet,
+// and the one before it in 'previous' (NULL if there is none). Older snapshots
+// are released, both stay valid until the next call.
+const struct snapshot * acquireSnapshot(struct snapshotRing * ring, const struct snapshot ** previous);
+
+// blends the positions and normals of the two snapshots at the current wall-clock
+// time, delayed by one snapshot interval so the time falls between them, into 'p' and 'n'
+void interpolateSnapshots(const struct snapshot * previous, const struct snapshot * newest,
+                          std::vector<struct point> & p, std::vector<struct point> & n);
+
+// wall-clock time in seconds
+double wallClock();
+
+// publishes 'positions' (512 per body) as the state after 'step' timesteps to
+// the shared memory and the stream of other processes, where they are enabled
+void publishPositions(const std::vector<struct point> & positions, long step, double time);
+
+// asks the physics thread to wake every body up before its next step
+void requestWake();
+
+// unblocks the physics thread to recheck the user settings (e.g. after pause changed)
+void notifySimulation();
+
+// true while the physics thread is blocked on a paused scene or a scene
+// with every body asleep. The state it stopped in has been published.
+bool simulationStill();
+
+#endif
+
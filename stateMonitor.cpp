@@ -0,0 +1,234 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// stateMonitor utility, follows the frames a running jello publishes in
+// shared memory (-shm) and prints a line of metrics every interval. It is
+// also the example client of sharedState.h: the frames are read in place,
+// with no copies and no system calls besides the sleep between lines.
+// With -socket it follows the stream of a jello started with -stream
+// instead, decoding every frame (stateStream.h)
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "sharedState.h"
+#include "stateStream.h"
+
+// Metrics of one Frame
+struct frameMetrics
+{
+    long step;
+    double time;
+    double centroid[3];  // of every point of every body
+    double lowest;       // smallest z of any point
+};
+
+/**
+ * measurePositions - Computes the Centroid and Lowest Point of the Positions
+ */
+static void measurePositions(const double * p, int points, struct frameMetrics * metrics)
+{
+    metrics->centroid[0] = metrics->centroid[1] = metrics->centroid[2] = 0.0;
+    metrics->lowest = p[2];
+
+    for (int i=0; i<points; i++)
+    {
+        metrics->centroid[0] += p[3*i];
+        metrics->centroid[1] += p[3*i+1];
+        metrics->centroid[2] += p[3*i+2];
+        metrics->lowest = std::min(metrics->lowest, p[3*i+2]);
+    }
+
+    for (int c=0; c<3; c++)
+    {
+        metrics->centroid[c] /= points;
+    }
+}
+
+/**
+ * measureFrame - Computes the Metrics of a Frame, Reading it in Place
+ *
+ * @return - Returns false if nothing was published yet
+ */
+static bool measureFrame(const struct sharedStateClient * client, struct frameMetrics * metrics, long * retries)
+{
+    for (;;)
+    {
+        uint32_t ticket;
+        const struct sharedFrame * frame = beginSharedRead(client, &ticket);
+        if (frame == NULL)
+        {
+            return false;
+        }
+
+        struct frameMetrics result;
+        result.step = frame->step;
+        result.time = frame->time;
+        measurePositions(sharedPositions(frame), 512 * client->header->bodies, &result);
+
+        // Keep it only if the Publisher did not come back to the Buffer meanwhile
+        if (endSharedRead(client, ticket))
+        {
+            *metrics = result;
+            return true;
+        }
+        (*retries)++;
+    }
+}
+
+/**
+ * followStream - Reads every Frame of a Stream, Printing the
+ *                Metrics of the Newest one every Interval
+ */
+static int followStream(const char * path, int interval, long lines)
+{
+    struct streamClient client;
+    if (!connectStream(path, &client))
+    {
+        printf("No jello is streaming to %s\n", path);
+        return 1;
+    }
+
+    printf("%s: %u jellos, a frame every %d timesteps of %g s, quantum %g, keyframe every %u frames\n", path,
+           client.header.bodies, client.header.n, client.header.dt, client.header.quantum, client.header.keyframeInterval);
+
+    std::vector<double> p(3 * 512 * (size_t) client.header.bodies);
+    struct streamFrame frame;
+
+    long frames = 0, keyframes = 0, dropped = 0;
+    long long bytes = client.bytes;
+    long line = 0;
+
+    struct timespec last;
+    clock_gettime(CLOCK_MONOTONIC, &last);
+
+    while (((lines == 0) || (line < lines)) && readStreamFrame(&client, &frame, &p[0]))
+    {
+        frames++;
+        keyframes += frame.keyframe;
+        dropped += frame.dropped;
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec - last.tv_sec) * 1000 + (now.tv_nsec - last.tv_nsec) / 1000000 < interval)
+        {
+            continue;
+        }
+        last = now;
+
+        struct frameMetrics metrics;
+        metrics.step = frame.step;
+        metrics.time = frame.time;
+        measurePositions(&p[0], 512 * client.header.bodies, &metrics);
+
+        printf("step %ld  t %.4f s  centroid %.4f %.4f %.4f  lowest %.4f  frames %ld  keyframes %ld  dropped %ld  bytes/frame %.0f\n",
+               metrics.step, metrics.time, metrics.centroid[0], metrics.centroid[1], metrics.centroid[2],
+               metrics.lowest, frames, keyframes, dropped, (double) (client.bytes - bytes) / frames);
+
+        frames = keyframes = dropped = 0;
+        bytes = client.bytes;
+        line++;
+    }
+
+    if ((lines == 0) || (line < lines))
+    {
+        printf("The jello stopped streaming\n");
+    }
+
+    closeStream(&client);
+    return 0;
+}
+
+int main(int argc, char ** argv)
+{
+    int interval = 500;
+    long lines = 0;
+    const char * socketPath = NULL;
+
+    // Parse the Options in front of the Name
+    int arg = 1;
+    while ((arg < argc) && (argv[arg][0] == '-'))
+    {
+        if ((strcmp(argv[arg], "-interval") == 0) && (arg + 1 < argc))
+        {
+            interval = std::max(1, atoi(argv[++arg]));
+        }
+        else if ((strcmp(argv[arg], "-count") == 0) && (arg + 1 < argc))
+        {
+            lines = std::max(0, atoi(argv[++arg]));
+        }
+        else if ((strcmp(argv[arg], "-socket") == 0) && (arg + 1 < argc))
+        {
+            socketPath = argv[++arg];
+        }
+        else
+        {
+            break;
+        }
+        arg++;
+    }
+
+    if (argc - arg != ((socketPath != NULL) ? 0 : 1))
+    {
+        printf ("Usage: %s [-interval milliseconds] [-count lines] (/name | -socket path)\n", argv[0]);
+        printf ("Prints the state a jello started with -shm /name publishes, or -stream path streams, until it stops.\n");
+        exit(0);
+    }
+
+    if (socketPath != NULL)
+    {
+        return followStream(socketPath, interval, lines);
+    }
+
+    struct sharedStateClient client;
+    if (!openSharedState(argv[arg], &client))
+    {
+        printf("No jello is publishing to %s\n", argv[arg]);
+        exit(1);
+    }
+
+    printf("%s: %u jellos, a frame every %d timesteps of %g s\n", argv[arg], client.header->bodies,
+           client.header->n, client.header->dt);
+
+    struct timespec pause;
+    pause.tv_sec = interval / 1000;
+    pause.tv_nsec = (interval % 1000) * 1000000L;
+
+    long retries = 0;
+    uint32_t lastSequence = client.header->sequence.load();
+
+    for (long line=0; (lines == 0) || (line < lines); line++)
+    {
+        bool closed = sharedStateClosed(&client);
+
+        struct frameMetrics metrics;
+        if (measureFrame(&client, &metrics, &retries))
+        {
+            uint32_t sequence = client.header->sequence.load();
+            printf("step %ld  t %.4f s  centroid %.4f %.4f %.4f  lowest %.4f  frames %u  retries %ld\n",
+                   metrics.step, metrics.time, metrics.centroid[0], metrics.centroid[1], metrics.centroid[2],
+                   metrics.lowest, (sequence / 2) - (lastSequence / 2), retries);
+            lastSequence = sequence;
+        }
+
+        if (closed)
+        {
+            printf("The jello stopped publishing\n");
+            break;
+        }
+
+        nanosleep(&pause, NULL);
+    }
+
+    closeSharedState(&client);
+    return 0;
+}
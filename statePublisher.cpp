@@ -0,0 +1,146 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers (not jello.h, see sharedState.h)
+#include "sharedState.h"
+#include "statePublisher.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <new>
+
+// Publisher State
+struct statePublisher
+{
+    std::string name;
+    void * base;
+    size_t length;
+    struct sharedStateHeader * header;
+    uint32_t sequence;          // counter before the frame being written
+    bool stopped;
+};
+
+static struct statePublisher * publisher = NULL;
+
+/**
+ * startPublisher - Creates and Maps the Shared-Memory Segment
+ */
+int startPublisher(const char * name, int bodies, double dt, int n)
+{
+    if (publisher != NULL)
+    {
+        return 1;
+    }
+
+    // Replace the Segment a Crashed Run may have Left
+    shm_unlink(name);
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        printf("Can't create the shared memory %s\n", name);
+        return 0;
+    }
+
+    uint32_t frameBytes;
+    size_t length = sharedStateSize(bodies, &frameBytes);
+    void * base = MAP_FAILED;
+    if (ftruncate(fd, length) == 0)
+    {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        printf("Can't map the shared memory %s\n", name);
+        shm_unlink(name);
+        return 0;
+    }
+
+    // Nothing Published yet, the Clients Check the Magic Last
+    struct sharedStateHeader * header = new (base) sharedStateHeader();
+    header->version = SHARED_STATE_VERSION;
+    header->bodies = bodies;
+    header->frameBytes = frameBytes;
+    header->n = n;
+    header->dt = dt;
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, SHARED_STATE_MAGIC, 8);
+
+    publisher = new statePublisher();
+    publisher->name = name;
+    publisher->base = base;
+    publisher->length = length;
+    publisher->header = header;
+    publisher->sequence = 0;
+    publisher->stopped = false;
+
+    atexit(stopPublisher);
+
+    printf("Publishing the state to the shared memory %s (%lu bytes)\n", name, (unsigned long) length);
+
+    return 1;
+}
+
+/**
+ * beginPublish - Marks a Write as in Progress and Returns
+ *                the Buffer that is not Published
+ */
+double * beginPublish()
+{
+    if ((publisher == NULL) || publisher->stopped)
+    {
+        return NULL;
+    }
+
+    // Mark the Write as in Progress
+    uint32_t sequence = publisher->header->sequence.load(std::memory_order_relaxed);
+    publisher->sequence = sequence;
+    publisher->header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Fill the Buffer that is not Published
+    return (double *) sharedPositions(sharedBuffer(publisher->base, ((sequence / 2) + 1) % 2));
+}
+
+/**
+ * endPublish - Publishes the Buffer Filled since beginPublish
+ */
+void endPublish(long step, double time)
+{
+    if ((publisher == NULL) || publisher->stopped)
+    {
+        return;
+    }
+
+    uint32_t sequence = publisher->sequence;
+    struct sharedFrame * frame = sharedBuffer(publisher->base, ((sequence / 2) + 1) % 2);
+    frame->step = step;
+    frame->time = time;
+
+    // Publish it
+    publisher->header->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * stopPublisher - Closes the Segment
+ */
+void stopPublisher()
+{
+    if ((publisher == NULL) || publisher->stopped)
+    {
+        return;
+    }
+    publisher->stopped = true;
+
+    publisher->header->closed.store(1, std::memory_order_release);
+    munmap(publisher->base, publisher->length);
+    shm_unlink(publisher->name.c_str());
+}
@@ -0,0 +1,31 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _STATEPUBLISHER_H_
+#define _STATEPUBLISHER_H_
+
+// Publisher Side of the Shared-Memory Segment (see sharedState.h for the
+// layout and the clients). Frames are written by a single thread.
+
+// creates the POSIX shared-memory segment 'name' (e.g. "/jello") for 'bodies' jellos
+// stepped with 'dt', one frame every 'n' timesteps. stopPublisher is registered with
+// atexit. Returns 0 if the segment can't be created.
+int startPublisher(const char * name, int bodies, double dt, int n);
+
+// returns the positions of the frame buffer that is not published (512 mass points
+// of x y z per body, in body order) for the caller to fill, or NULL if nothing is
+// published. Hand it over with endPublish.
+double * beginPublish();
+
+// publishes the filled frame buffer as the state after 'step' timesteps
+void endPublish(long step, double time);
+
+// marks the segment as closed and removes its name (mapped clients keep the last frame)
+void stopPublisher();
+
+#endif
+
@@ -0,0 +1,221 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _STATESTREAM_H_
+#define _STATESTREAM_H_
+
+// Stream of Frames a running Jello sends over a UNIX Domain Socket (-stream path),
+// and the Client Side. Like sharedState.h this header stands alone, and includes
+// unistd.h, so the simulator only includes it in streamServer.cpp.
+//
+// On connecting, a client gets a streamHeader, then one streamFrame and its 'size'
+// bytes of values per frame (native byte order). Every coordinate is quantized to
+// a multiple of 'quantum', and a frame holds the zigzag mapped numbers, bit-packed
+// in blocks (see deltaCodec.h), of:
+//   keyframe: the quantized values, then the quantized values minus the ones of
+//             the previous frame (so the next frame can be predicted from it)
+//   else:     the quantized values minus the prediction 2 * previous - the one
+//             before, the positions moving on at the speed of the last frame
+// A client always starts with a keyframe, and gets one every 'keyframeInterval'
+// frames. A client too slow to take a frame misses it, and starts over from the
+// keyframe it gets with the next frame it can take.
+//
+//   struct streamClient client;
+//   if (connectStream("/tmp/jello.sock", &client))
+//   {
+//       struct streamFrame frame;
+//       std::vector<double> p(3 * 512 * client.header.bodies);
+//       while (readStreamFrame(&client, &frame, &p[0])) { ... }
+//       closeStream(&client);
+//   }
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "deltaCodec.h"
+
+#define STREAM_MAGIC "JELLOSTR"
+#define STREAM_VERSION 1
+
+// frames between keyframes
+#define STREAM_KEYFRAME_INTERVAL 64
+
+// quantum of the positions (units of the bounding box, well below a pixel)
+#define STREAM_QUANTUM 1e-5
+
+struct streamHeader
+{
+    char magic[8];              // STREAM_MAGIC
+    uint32_t version;           // STREAM_VERSION
+    uint32_t bodies;            // jellos in the scene, 512 mass points each
+    uint32_t keyframeInterval;  // frames between keyframes
+    int32_t n;                  // timesteps per frame
+    double dt;                  // timestep
+    double quantum;             // quantum of the positions
+};
+
+struct streamFrame
+{
+    char tag[4];                // "FRME"
+    uint32_t size;              // bytes of values after the frame header
+    uint32_t keyframe;          // 1 if the values don't depend on the previous frames
+    uint32_t dropped;           // frames this client missed since the last one it got
+    int64_t step;               // timesteps performed
+    double time;                // simulated time
+};
+
+// Connection of a Client, with the Decoder State
+struct streamClient
+{
+    int fd;
+    struct streamHeader header;
+    std::vector<long long> current;     // quantized values of the last frame
+    std::vector<long long> previous;    // and of the one before
+    std::vector<unsigned long long> values;
+    std::vector<unsigned char> payload;
+    bool synced;                        // a keyframe was read
+    long long bytes;                    // bytes read so far
+};
+
+// reads exactly 'size' bytes, returns false at the end of the stream
+static inline bool readStreamBytes(struct streamClient * client, void * data, size_t size)
+{
+    unsigned char * out = (unsigned char *) data;
+    while (size > 0)
+    {
+        ssize_t got = recv(client->fd, out, size, 0);
+        if ((got < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            return false;
+        }
+
+        out += got;
+        size -= got;
+        client->bytes += got;
+    }
+    return true;
+}
+
+// connects to the jello streaming to the socket 'path' and reads the header
+// returns 0 if there is none
+static inline int connectStream(const char * path, struct streamClient * client)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return 0;
+    }
+    strcpy(address.sun_path, path);
+
+    client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client->fd < 0)
+    {
+        return 0;
+    }
+
+    client->bytes = 0;
+    client->synced = false;
+    if ((connect(client->fd, (struct sockaddr *) &address, sizeof(address)) != 0) ||
+        !readStreamBytes(client, &client->header, sizeof(client->header)) ||
+        (memcmp(client->header.magic, STREAM_MAGIC, 8) != 0) || (client->header.version != STREAM_VERSION))
+    {
+        close(client->fd);
+        return 0;
+    }
+
+    size_t count = (size_t) client->header.bodies * 512 * 3;
+    client->current.assign(count, 0);
+    client->previous.assign(count, 0);
+    client->values.resize(count);
+    return 1;
+}
+
+// reads the next frame into 'frame' and its positions (3 * 512 per body) into
+// 'positions', waiting for it. Returns 0 at the end of the stream or on an error.
+static inline int readStreamFrame(struct streamClient * client, struct streamFrame * frame, double * positions)
+{
+    if (!readStreamBytes(client, frame, sizeof(*frame)) || (memcmp(frame->tag, "FRME", 4) != 0))
+    {
+        return 0;
+    }
+
+    client->payload.resize(frame->size);
+    if ((frame->size > 0) && !readStreamBytes(client, &client->payload[0], frame->size))
+    {
+        return 0;
+    }
+
+    size_t count = client->current.size();
+    const unsigned char * in = client->payload.data();
+    const unsigned char * end = in + frame->size;
+    long long * current = client->current.data();
+    long long * previous = client->previous.data();
+    unsigned long long * values = client->values.data();
+
+    if (frame->keyframe)
+    {
+        // The Values, then their Change since the Previous Frame
+        if ((in = unpackBlocks(in, end, values, count)) == NULL)
+        {
+            return 0;
+        }
+        for (size_t i=0; i<count; i++)
+        {
+            current[i] = unzigzag(values[i]);
+        }
+
+        if (unpackBlocks(in, end, values, count) == NULL)
+        {
+            return 0;
+        }
+        for (size_t i=0; i<count; i++)
+        {
+            previous[i] = current[i] - unzigzag(values[i]);
+        }
+        client->synced = true;
+    }
+    else
+    {
+        // Residuals of the Prediction from the last two Frames
+        if (!client->synced || (unpackBlocks(in, end, values, count) == NULL))
+        {
+            return 0;
+        }
+        for (size_t i=0; i<count; i++)
+        {
+            long long next = 2 * current[i] - previous[i] + unzigzag(values[i]);
+            previous[i] = current[i];
+            current[i] = next;
+        }
+    }
+
+    for (size_t i=0; i<count; i++)
+    {
+        positions[i] = current[i] * client->header.quantum;
+    }
+    return 1;
+}
+
+// closes the connection
+static inline void closeStream(struct streamClient * client)
+{
+    close(client->fd);
+    client->fd = -1;
+}
+
+#endif
+
@@ -0,0 +1,496 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers (not jello.h, see stateStream.h)
+#include "stateStream.h"
+#include "streamServer.h"
+#include "frameWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// macOS has no MSG_NOSIGNAL, its Sockets are set to SO_NOSIGPIPE instead
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Positions of a Frame, Waiting for the Sender
+struct streamedFrame
+{
+    std::vector<double> p;
+    long step;
+    double time;
+};
+
+// Connection of a Client
+struct streamConnection
+{
+    int fd;
+    std::vector<unsigned char> pending;     // bytes not taken by the socket yet
+    size_t sent;                            // of them, the ones it took
+    bool synced;                            // got the previous frame, deltas can follow
+    uint32_t dropped;                       // frames missed since the last one sent
+};
+
+// Server State (never freed, see frameWriter.h)
+struct streamServer
+{
+    frameWriter<struct streamedFrame> writer; // written by the sender, see senderLoop
+    std::thread sender;
+    std::atomic<bool> stopping;
+    struct streamedFrame * filling;         // frame between beginStream and endStream
+
+    std::string path;
+    struct streamHeader header;
+    int listenFd;
+    int wake[2];                            // pipe waking the sender for a frame
+    long behind;                            // frames dropped for all, with the sender behind
+
+    // Sender State
+    std::vector<struct streamConnection *> clients;
+    std::vector<long long> q, q1, q0;       // quantized values of the last three frames
+    std::vector<unsigned long long> values;
+    std::vector<unsigned char> keyframe;    // payloads of the frame, encoded when needed
+    std::vector<unsigned char> delta;
+    long frame;                             // frames encoded
+    long sentFrames;                        // frames sent, over all clients
+    long long sentBytes;
+    long dropped;                           // frames dropped for slow clients
+    bool stopped;
+
+    streamServer() : writer(STREAM_BUFFERS), stopping(false), filling(NULL), listenFd(-1),
+                     behind(0), frame(0), sentFrames(0), sentBytes(0), dropped(0), stopped(false) {}
+};
+
+static struct streamServer * server = NULL;
+
+/**
+ * closeConnection - Disconnects a Client
+ */
+static void closeConnection(size_t c)
+{
+    close(server->clients[c]->fd);
+    delete server->clients[c];
+    server->clients.erase(server->clients.begin() + c);
+}
+
+/**
+ * flushConnection - Hands the Socket what it Takes of the Pending Bytes
+ *
+ * @return - Returns false if the Client is gone
+ */
+static bool flushConnection(struct streamConnection * client)
+{
+    while (client->sent < client->pending.size())
+    {
+        ssize_t written = send(client->fd, &client->pending[client->sent], client->pending.size() - client->sent, MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+        }
+        client->sent += written;
+    }
+
+    client->pending.clear();
+    client->sent = 0;
+    return true;
+}
+
+/**
+ * acceptConnections - Takes the Clients Waiting to Connect
+ *                     and Queues the Header for them
+ */
+static void acceptConnections()
+{
+    int fd;
+    while ((fd = accept(server->listenFd, NULL, NULL)) >= 0)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+        struct streamConnection * client = new streamConnection();
+        client->fd = fd;
+        client->sent = 0;
+        client->synced = false;
+        client->dropped = 0;
+
+        const unsigned char * header = (const unsigned char *) &server->header;
+        client->pending.assign(header, header + sizeof(server->header));
+
+        if (flushConnection(client))
+        {
+            server->clients.push_back(client);
+        }
+        else
+        {
+            close(fd);
+            delete client;
+        }
+    }
+}
+
+/**
+ * encodeKeyframe - Packs the Values of the Frame, then
+ *                  their Change since the Previous One
+ */
+static void encodeKeyframe()
+{
+    size_t count = server->q.size();
+    server->keyframe.resize(2 * PACKED_MAX_BYTES(count));
+
+    for (size_t i=0; i<count; i++)
+    {
+        server->values[i] = zigzag(server->q[i]);
+    }
+    unsigned char * out = packBlocks(&server->keyframe[0], server->values.data(), count);
+
+    for (size_t i=0; i<count; i++)
+    {
+        server->values[i] = zigzag(server->q[i] - server->q1[i]);
+    }
+    out = packBlocks(out, server->values.data(), count);
+
+    server->keyframe.resize(out - &server->keyframe[0]);
+}
+
+/**
+ * encodeDelta - Packs the Residuals of Predicting the Frame
+ *               from the Previous Two
+ */
+static void encodeDelta()
+{
+    size_t count = server->q.size();
+    server->delta.resize(PACKED_MAX_BYTES(count));
+
+    for (size_t i=0; i<count; i++)
+    {
+        server->values[i] = zigzag(server->q[i] - (2 * server->q1[i] - server->q0[i]));
+    }
+    unsigned char * out = packBlocks(&server->delta[0], server->values.data(), count);
+
+    server->delta.resize(out - &server->delta[0]);
+}
+
+/**
+ * sendFrame - Encodes a Frame and Queues it for the Clients
+ *             that took the Previous One
+ */
+static void sendFrame(const struct streamedFrame * frame)
+{
+    // Quantize it, Keeping the Previous Two
+    server->q0.swap(server->q1);
+    server->q1.swap(server->q);
+    for (size_t i=0; i<server->q.size(); i++)
+    {
+        server->q[i] = quantize(frame->p[i], server->header.quantum);
+    }
+    if (server->frame == 0)
+    {
+        server->q1 = server->q0 = server->q;
+    }
+
+    bool keyframeDue = (server->frame % server->header.keyframeInterval == 0);
+    server->frame++;
+    server->keyframe.clear();
+    server->delta.clear();
+
+    for (size_t c=0; c<server->clients.size(); c++)
+    {
+        struct streamConnection * client = server->clients[c];
+
+        // Drop the Frame for a Client still Taking the Previous One
+        if (!client->pending.empty())
+        {
+            client->synced = false;
+            client->dropped++;
+            server->dropped++;
+            continue;
+        }
+
+        // A Keyframe Catches up a Client that Missed Frames
+        bool keyframe = keyframeDue || !client->synced;
+        std::vector<unsigned char> & payload = keyframe ? server->keyframe : server->delta;
+        if (payload.empty())
+        {
+            keyframe ? encodeKeyframe() : encodeDelta();
+        }
+
+        struct streamFrame message;
+        memcpy(message.tag, "FRME", 4);
+        message.size = payload.size();
+        message.keyframe = keyframe ? 1 : 0;
+        message.dropped = client->dropped;
+        message.step = frame->step;
+        message.time = frame->time;
+
+        const unsigned char * bytes = (const unsigned char *) &message;
+        client->pending.insert(client->pending.end(), bytes, bytes + sizeof(message));
+        client->pending.insert(client->pending.end(), payload.begin(), payload.end());
+        client->synced = true;
+        client->dropped = 0;
+
+        server->sentFrames++;
+        server->sentBytes += sizeof(message) + payload.size();
+
+        if (!flushConnection(client))
+        {
+            closeConnection(c--);
+        }
+    }
+}
+
+/**
+ * senderLoop - Main Loop of the Sender Thread, Waiting on the Sockets
+ *              and on the Physics Thread at once
+ */
+static void senderLoop()
+{
+    std::vector<struct pollfd> polled;
+    unsigned char ignored[256];
+
+    while (!server->stopping.load())
+    {
+        // The Wake Pipe, the Listening Socket, then the Clients
+        polled.resize(2 + server->clients.size());
+        polled[0].fd = server->wake[0];
+        polled[0].events = POLLIN;
+        polled[1].fd = server->listenFd;
+        polled[1].events = POLLIN;
+        for (size_t c=0; c<server->clients.size(); c++)
+        {
+            polled[2 + c].fd = server->clients[c]->fd;
+            polled[2 + c].events = POLLIN | (server->clients[c]->pending.empty() ? 0 : POLLOUT);
+        }
+
+        if (poll(&polled[0], polled.size(), -1) < 0)
+        {
+            continue;
+        }
+
+        // Clients only Hang up, and Take the Pending Bytes
+        for (size_t c=server->clients.size(); c-- > 0; )
+        {
+            short events = polled[2 + c].revents;
+            bool open = true;
+
+            if (events & (POLLIN | POLLHUP | POLLERR))
+            {
+                ssize_t got = recv(server->clients[c]->fd, ignored, sizeof(ignored), 0);
+                open = (got > 0) || ((got < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)));
+            }
+            if (open && (events & POLLOUT))
+            {
+                open = flushConnection(server->clients[c]);
+            }
+            if (!open)
+            {
+                closeConnection(c);
+            }
+        }
+
+        if (polled[1].revents & POLLIN)
+        {
+            acceptConnections();
+        }
+
+        // Send the Queued Frames
+        if (polled[0].revents & POLLIN)
+        {
+            while (read(server->wake[0], ignored, sizeof(ignored)) > 0)
+            {
+            }
+        }
+
+        struct streamedFrame * frame;
+        while (server->writer.tryNext(frame))
+        {
+            sendFrame(frame);
+            server->writer.release(frame);
+        }
+    }
+}
+
+/**
+ * startStreaming - Creates the Listening Socket and
+ *                  Starts the Sender Thread
+ */
+int startStreaming(const char * path, int bodies, double dt, int n)
+{
+    if (server != NULL)
+    {
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        printf("The socket path %s is too long\n", path);
+        return 0;
+    }
+    strcpy(address.sun_path, path);
+
+    // Replace the Socket a Crashed Run may have Left
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((fd < 0) || (bind(fd, (struct sockaddr *) &address, sizeof(address)) != 0) || (listen(fd, 8) != 0))
+    {
+        printf("Can't listen on the socket %s\n", path);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return 0;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    server = new streamServer();
+    server->path = path;
+    server->listenFd = fd;
+
+    // Neither Side of the Wake Pipe Blocks, a Full Pipe already Wakes the Sender
+    if (pipe(server->wake) != 0)
+    {
+        printf("Can't create the pipe of the stream\n");
+        return 0;
+    }
+    for (int i=0; i<2; i++)
+    {
+        fcntl(server->wake[i], F_SETFL, fcntl(server->wake[i], F_GETFL) | O_NONBLOCK);
+    }
+
+    memset(&server->header, 0, sizeof(server->header));
+    memcpy(server->header.magic, STREAM_MAGIC, 8);
+    server->header.version = STREAM_VERSION;
+    server->header.bodies = bodies;
+    server->header.keyframeInterval = STREAM_KEYFRAME_INTERVAL;
+    server->header.n = n;
+    server->header.dt = dt;
+    server->header.quantum = STREAM_QUANTUM;
+
+    size_t count = (size_t) bodies * 512 * 3;
+    server->q.assign(count, 0);
+    server->q1.assign(count, 0);
+    server->q0.assign(count, 0);
+    server->values.resize(count);
+
+    // Frames Reused by the Physics Thread
+    for (int i=0; i<STREAM_BUFFERS; i++)
+    {
+        struct streamedFrame * frame = new streamedFrame();
+        frame->p.resize(count);
+        server->writer.addFrame(frame);
+    }
+
+    server->sender = std::thread(senderLoop);
+    atexit(stopStreaming);
+
+    printf("Streaming the state to the socket %s (%lu bytes per raw frame)\n", path,
+           (unsigned long) (count * sizeof(double)));
+
+    return 1;
+}
+
+/**
+ * beginStream - Takes a Free Frame, or Drops this one
+ *               if the Sender is Behind
+ */
+double * beginStream()
+{
+    if ((server == NULL) || server->stopped)
+    {
+        return NULL;
+    }
+
+    server->filling = server->writer.tryAcquire();
+    if (server->filling == NULL)
+    {
+        server->behind++;
+        return NULL;
+    }
+
+    return server->filling->p.data();
+}
+
+/**
+ * endStream - Queues the Frame Filled since beginStream
+ *             and Wakes the Sender
+ */
+void endStream(long step, double time)
+{
+    if ((server == NULL) || server->stopped || (server->filling == NULL))
+    {
+        return;
+    }
+
+    server->filling->step = step;
+    server->filling->time = time;
+    server->writer.submit(server->filling);
+    server->filling = NULL;
+
+    char wake = 'f';
+    if (write(server->wake[1], &wake, 1) < 0)
+    {
+        // The Pipe is Full, the Sender is Woken anyway
+    }
+}
+
+/**
+ * stopStreaming - Disconnects the Clients and Removes the Socket
+ */
+void stopStreaming()
+{
+    if ((server == NULL) || server->stopped)
+    {
+        return;
+    }
+    server->stopped = true;
+
+    // Stop the Sender
+    server->stopping.store(true);
+    char wake = 's';
+    if (write(server->wake[1], &wake, 1) < 0)
+    {
+        // The Pipe is Full, the Sender is Woken anyway
+    }
+    if (server->sender.joinable())
+    {
+        server->sender.join();
+    }
+    server->writer.stop();
+
+    while (!server->clients.empty())
+    {
+        closeConnection(server->clients.size() - 1);
+    }
+    close(server->listenFd);
+    close(server->wake[0]);
+    close(server->wake[1]);
+    unlink(server->path.c_str());
+
+    if (server->sentFrames > 0)
+    {
+        printf("Streamed %ld frames to the clients of %s, %.0f bytes per frame (%lu raw), %ld dropped for slow clients, %ld with the sender behind\n",
+               server->sentFrames, server->path.c_str(), (double) server->sentBytes / server->sentFrames,
+               (unsigned long) (server->q.size() * sizeof(double)), server->dropped, server->behind);
+    }
+}
+
@@ -0,0 +1,38 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _STREAMSERVER_H_
+#define _STREAMSERVER_H_
+
+// Server Side of the Frame Stream (see stateStream.h for the format and the
+// clients). A sender thread encodes the frames and writes them to every client
+// without waiting: a frame is dropped for a client that did not take the last
+// one yet, and dropped for all when the sender is behind, so the simulation
+// never waits for a client.
+
+// number of frames waiting for the sender thread
+#define STREAM_BUFFERS 4
+
+// listens on the UNIX domain socket 'path' for clients of the frames of 'bodies'
+// jellos stepped with 'dt', one frame every 'n' timesteps, and starts the sender
+// thread. stopStreaming is registered with atexit. Returns 0 if the socket can't
+// be created.
+int startStreaming(const char * path, int bodies, double dt, int n);
+
+// returns the positions of a free frame (512 mass points of x y z per body, in body
+// order) for the caller to fill, or NULL if nothing is streamed or the sender is
+// behind (the frame is dropped). Hand it over with endStream.
+double * beginStream();
+
+// queues the filled frame as the state after 'step' timesteps
+void endStream(long step, double time);
+
+// disconnects the clients, stops the sender thread and removes the socket
+void stopStreaming();
+
+#endif
+
@@ -0,0 +1,278 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "showCube.h"
+#include "surfaceMesh.h"
+
+struct surfaceMesh surface;
+
+// Neighbours Drawn for every Spring Type (as in showCube)
+static const int structuralNeighbours[6][3] = { {1,0,0}, {0,1,0}, {0,0,1}, {-1,0,0}, {0,-1,0}, {0,0,-1} };
+static const int shearNeighbours[20][3] = { {1,1,0}, {-1,1,0}, {-1,-1,0}, {1,-1,0}, {0,1,1}, {0,-1,1}, {0,-1,-1}, {0,1,-1},
+                                            {1,0,1}, {-1,0,1}, {-1,0,-1}, {1,0,-1}, {1,1,1}, {-1,1,1}, {-1,-1,1}, {1,-1,1},
+                                            {1,1,-1}, {-1,1,-1}, {-1,-1,-1}, {1,-1,-1} };
+static const int bendNeighbours[6][3] = { {2,0,0}, {0,2,0}, {0,0,2}, {-2,0,0}, {0,-2,0}, {0,0,-2} };
+
+/**
+ * faceVertex - Gets the Surface Vertex at
+ *              position (i,j) of a Cube Face
+ */
+static int faceVertex(int face, int i, int j)
+{
+    // Map the Face Position to the Mass Point
+    int node = pointMap(face, i, j);
+
+    return surface.index[node / 64][(node / 8) % 8][node % 8];
+}
+
+/**
+ * buildWireLines - Lists the Springs between Surface Points,
+ *                  each Spring once from its Lower End
+ */
+static void buildWireLines(const int (*neighbours)[3], int count, std::vector<unsigned short> & lines)
+{
+    lines.clear();
+
+    for (int s=0; s<SURFACE_VERTICES; s++)
+    {
+        int i = surface.vertex[s][0];
+        int j = surface.vertex[s][1];
+        int k = surface.vertex[s][2];
+
+        for (int n=0; n<count; n++)
+        {
+            int ip = i + neighbours[n][0];
+            int jp = j + neighbours[n][1];
+            int kp = k + neighbours[n][2];
+
+            // The Neighbour has to be a Surface Point inside the Cube
+            if ((ip>7) || (ip<0) || (jp>7) || (jp<0) || (kp>7) || (kp<0) || (surface.index[ip][jp][kp] < 0))
+            {
+                continue;
+            }
+
+            // The Neighbours are Symmetric, keep the Spring from its Lower End
+            if (64*ip + 8*jp + kp < 64*i + 8*j + k)
+            {
+                continue;
+            }
+
+            lines.push_back(64*i + 8*j + k);
+            lines.push_back(64*ip + 8*jp + kp);
+        }
+    }
+}
+
+/**
+ * buildSurfaceMesh - Builds the Surface Vertices and the
+ *                    outward wound Surface Triangles
+ */
+void buildSurfaceMesh()
+{
+    int i,j,k;
+    int vertices = 0;
+    int triangles = 0;
+
+    // Number the Mass Points on the Surface of the Cube
+    for (i=0; i<=7; i++)
+    {
+        for (j=0; j<=7; j++)
+        {
+            for (k=0; k<=7; k++)
+            {
+                // Check for an Interior Point
+                if (i*j*k*(7-i)*(7-j)*(7-k) != 0)
+                {
+                    surface.index[i][j][k] = -1;
+                    continue;
+                }
+
+                surface.vertex[vertices][0] = i;
+                surface.vertex[vertices][1] = j;
+                surface.vertex[vertices][2] = k;
+                surface.index[i][j][k] = vertices++;
+            }
+        }
+    }
+
+    // Triangulate the Six Faces the same way showCube does
+    // (1 = bottom, 2 = front, 3 = left, 4 = right, 5 = far, 6 = top)
+    for (int face=1; face<=6; face++)
+    {
+        // Faces 1, 3 and 5 have flipped orientation
+        bool flip = (face == 1) || (face == 3) || (face == 5);
+
+        for (i=0; i<=6; i++)
+        {
+            for (j=0; j<=6; j++)
+            {
+                // First Triangle of Block (i,j)
+                int * t = surface.triangle[triangles++];
+                t[0] = faceVertex(face, i, j);
+                t[1] = faceVertex(face, flip ? i : i+1, flip ? j+1 : j);
+                t[2] = faceVertex(face, flip ? i+1 : i, flip ? j : j+1);
+
+                // Second Triangle of Block (i,j)
+                t = surface.triangle[triangles++];
+                t[0] = faceVertex(face, i+1, j+1);
+                t[1] = faceVertex(face, flip ? i+1 : i, flip ? j : j+1);
+                t[2] = faceVertex(face, flip ? i : i+1, flip ? j+1 : j);
+            }
+        }
+    }
+
+    // Wireframe
+    for (int s=0; s<SURFACE_VERTICES; s++)
+    {
+        surface.wirePoint[s] = 64 * surface.vertex[s][0] + 8 * surface.vertex[s][1] + surface.vertex[s][2];
+    }
+    buildWireLines(structuralNeighbours, 6, surface.structuralLines);
+    buildWireLines(shearNeighbours, 20, surface.shearLines);
+    buildWireLines(bendNeighbours, 6, surface.bendLines);
+
+    // Number the Face Vertices
+    triangles = 0;
+    for (int face=1; face<=6; face++)
+    {
+        int base = 64 * (face - 1);
+        bool flip = (face == 1) || (face == 3) || (face == 5);
+
+        for (i=0; i<=7; i++)
+        {
+            for (j=0; j<=7; j++)
+            {
+                surface.faceNode[base + 8*i + j] = pointMap(face, i, j);
+                surface.faceSign[base + 8*i + j] = ((i < 7) && (j < 7)) ? (flip ? -1.0 : 1.0) : 0.0;
+                surface.faceValence[base + 8*i + j] = 0.0;
+            }
+        }
+
+        // Count the Triangles sharing every Face Vertex
+        for (i=0; i<=6; i++)
+        {
+            for (j=0; j<=6; j++)
+            {
+                surface.faceValence[base + 8*(i+1) + j] += 2;
+                surface.faceValence[base + 8*i + (j+1)] += 2;
+                surface.faceValence[base + 8*i + j] += 1;
+                surface.faceValence[base + 8*(i+1) + (j+1)] += 1;
+            }
+        }
+
+        // Rendered Triangles, split along the other diagonal like the strips of showCube
+        for (j=1; j<=7; j++)
+        {
+            for (i=0; i<=6; i++)
+            {
+                unsigned short a = base + 8*i + j;
+                unsigned short b = base + 8*i + (j-1);
+                unsigned short c = base + 8*(i+1) + j;
+                unsigned short d = base + 8*(i+1) + (j-1);
+
+                unsigned short * t = surface.faceTriangle[triangles++];
+                t[0] = a;
+                t[1] = flip ? c : b;
+                t[2] = flip ? b : c;
+
+                t = surface.faceTriangle[triangles++];
+                t[0] = c;
+                t[1] = flip ? d : b;
+                t[2] = flip ? b : d;
+            }
+        }
+    }
+}
+
+/**
+ * computeFaceNormals - Computes the Gouraud Normals of all
+ *                      Face Vertices in one Pass
+ *
+ * The faces are regular 8 * 8 grids, so the block starting at face
+ * vertex v has its corners at v, v+1, v+8 and v+9. Every loop below runs
+ * over all face vertices with the same stencil and no branches (blocks
+ * past the face edges have a sign of 0), so the compiler vectorizes them
+ * (sqrt only vectorizes with -fno-math-errno).
+ */
+void computeFaceNormals(const struct point p[8][8][8], struct point normal[FACE_VERTICES])
+{
+    const int PAD = 9; // reach of the stencil
+
+    const struct point * node = &p[0][0][0];
+
+    // Gathered Positions, padded behind for the Corners of the Last Blocks
+    double x[FACE_VERTICES + PAD], y[FACE_VERTICES + PAD], z[FACE_VERTICES + PAD];
+
+    // Normalized Normals of the two Triangles of every Block, padded in front
+    // for the Blocks before the First Vertex
+    double ax[PAD + FACE_VERTICES], ay[PAD + FACE_VERTICES], az[PAD + FACE_VERTICES];
+    double bx[PAD + FACE_VERTICES], by[PAD + FACE_VERTICES], bz[PAD + FACE_VERTICES];
+
+    // Gather the Positions
+    for (int v=0; v<FACE_VERTICES; v++)
+    {
+        x[v] = node[surface.faceNode[v]].x;
+        y[v] = node[surface.faceNode[v]].y;
+        z[v] = node[surface.faceNode[v]].z;
+    }
+    for (int v=FACE_VERTICES; v<FACE_VERTICES + PAD; v++)
+    {
+        x[v] = y[v] = z[v] = 0.0;
+    }
+    for (int v=0; v<PAD; v++)
+    {
+        ax[v] = ay[v] = az[v] = 0.0;
+        bx[v] = by[v] = bz[v] = 0.0;
+    }
+
+    // Triangle Normals of every Block
+    for (int v=0; v<FACE_VERTICES; v++)
+    {
+        double sign = surface.faceSign[v];
+        double r1x, r1y, r1z, r2x, r2y, r2z, cx, cy, cz, length;
+
+        // first triangle (v, v+8, v+1)
+        r1x = x[v+8] - x[v]; r1y = y[v+8] - y[v]; r1z = z[v+8] - z[v];
+        r2x = x[v+1] - x[v]; r2y = y[v+1] - y[v]; r2z = z[v+1] - z[v];
+        CROSSPRODUCT(r1x,r1y,r1z, r2x,r2y,r2z, cx,cy,cz);
+        length = sqrt(cx * cx + cy * cy + cz * cz + (1.0 - sign * sign));
+        ax[PAD + v] = sign * cx / length;
+        ay[PAD + v] = sign * cy / length;
+        az[PAD + v] = sign * cz / length;
+
+        // second triangle (v+9, v+1, v+8)
+        r1x = x[v+1] - x[v+9]; r1y = y[v+1] - y[v+9]; r1z = z[v+1] - z[v+9];
+        r2x = x[v+8] - x[v+9]; r2y = y[v+8] - y[v+9]; r2z = z[v+8] - z[v+9];
+        CROSSPRODUCT(r1x,r1y,r1z, r2x,r2y,r2z, cx,cy,cz);
+        length = sqrt(cx * cx + cy * cy + cz * cz + (1.0 - sign * sign));
+        bx[PAD + v] = sign * cx / length;
+        by[PAD + v] = sign * cy / length;
+        bz[PAD + v] = sign * cz / length;
+    }
+
+    // Average the Triangles around every Vertex
+    // (first triangles of the blocks at v, v-8 and v-1, second ones of v-1, v-8 and v-9)
+    double nx[FACE_VERTICES], ny[FACE_VERTICES], nz[FACE_VERTICES];
+    for (int v=0; v<FACE_VERTICES; v++)
+    {
+        double valence = surface.faceValence[v];
+
+        nx[v] = (ax[PAD + v] + ax[PAD + v - 8] + ax[PAD + v - 1] + bx[PAD + v - 1] + bx[PAD + v - 8] + bx[PAD + v - 9]) / valence;
+        ny[v] = (ay[PAD + v] + ay[PAD + v - 8] + ay[PAD + v - 1] + by[PAD + v - 1] + by[PAD + v - 8] + by[PAD + v - 9]) / valence;
+        nz[v] = (az[PAD + v] + az[PAD + v - 8] + az[PAD + v - 1] + bz[PAD + v - 1] + bz[PAD + v - 8] + bz[PAD + v - 9]) / valence;
+    }
+
+    // Scatter the Normals
+    for (int v=0; v<FACE_VERTICES; v++)
+    {
+        normal[v].x = nx[v];
+        normal[v].y = ny[v];
+        normal[v].z = nz[v];
+    }
+}
+
@@ -0,0 +1,50 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _SURFACEMESH_H_
+#define _SURFACEMESH_H_
+
+#include <vector>
+
+// Surface Mesh Sizes
+#define SURFACE_VERTICES 296   // 512 mass points minus the 6 * 6 * 6 interior points
+#define SURFACE_TRIANGLES 588  // 6 faces * 7 * 7 blocks * 2 triangles
+#define FACE_VERTICES 384      // 6 faces * 8 * 8 points, the cube edges are repeated on every face they border
+
+// Triangulated Surface of the 8 * 8 * 8 Lattice
+// (topology only, positions are looked up in the jello)
+struct surfaceMesh
+{
+    int vertex[SURFACE_VERTICES][3];      // lattice indices (i,j,k) of every surface vertex
+    int index[8][8][8];                   // surface vertex of every mass point, -1 if interior
+    int triangle[SURFACE_TRIANGLES][3];   // surface vertices of every triangle, wound outwards
+
+    // Face Vertices for Gouraud Shading, every face with its own normals
+    // (face f, position (i,j) is face vertex 64 * (f-1) + 8 * i + j)
+    int faceNode[FACE_VERTICES];                  // mass point of every face vertex (64 * i + 8 * j + k)
+    double faceSign[FACE_VERTICES];               // orientation of the block starting at every face vertex, 0 past the face edge
+    double faceValence[FACE_VERTICES];            // triangles sharing every face vertex
+    unsigned short faceTriangle[SURFACE_TRIANGLES][3]; // face vertices of the rendered triangles, wound outwards
+
+    // Wireframe, by mass point (64 * i + 8 * j + k)
+    unsigned short wirePoint[SURFACE_VERTICES];    // every surface point
+    std::vector<unsigned short> structuralLines;   // springs between two surface points, two mass points per spring
+    std::vector<unsigned short> shearLines;
+    std::vector<unsigned short> bendLines;
+};
+
+extern struct surfaceMesh surface;
+
+// builds the surface mesh from the six faces of the cube
+void buildSurfaceMesh();
+
+// computes the Gouraud normals of the face vertices (the normalized triangle
+// normals averaged over every face, as showCube does) for all faces at once
+void computeFaceNormals(const struct point p[8][8][8], struct point normal[FACE_VERTICES]);
+
+#endif
+
@@ -0,0 +1,190 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "threadPool.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+// Represents the Shared Worker Pool
+// (allocated once and never freed, so worker
+// threads can outlive the static destructors at exit)
+struct threadPool
+{
+    std::mutex mutex;                  // guards the job fields below
+    std::mutex owner;                  // held by the thread running a job
+    std::condition_variable jobReady;  // signals workers that a job was posted
+    std::condition_variable jobDone;   // signals the caller that the workers finished
+
+    const std::function<void(int, int)> * body; // current job
+    int count;                                  // number of items in the current job
+    int grain;                                  // number of items per chunk
+    std::atomic<int> next;                      // first item of the next unclaimed chunk
+    int generation;                             // incremented for every posted job
+    int pending;                                // workers still busy with the current job
+
+    int size; // threads working on a job (including the caller)
+};
+
+static struct threadPool * pool = NULL;
+
+// Set on threads currently running chunks of a job
+static thread_local bool insideJob = false;
+
+/**
+ * runChunks - Claims and runs chunks of the current
+ *             job until none are left
+ */
+static void runChunks()
+{
+    // Get the Current Job
+    const std::function<void(int, int)> & body = *pool->body;
+    int count = pool->count;
+    int grain = pool->grain;
+
+    // Claim Chunks until the Range is Exhausted
+    int begin;
+    while ((begin = pool->next.fetch_add(grain)) < count)
+    {
+        int end = (begin + grain < count) ? (begin + grain) : count;
+        body(begin, end);
+    }
+}
+
+/**
+ * workerLoop - Main Loop of a Worker Thread
+ */
+static void workerLoop()
+{
+    // Last Job this Worker has taken part in
+    int seen = 0;
+
+    insideJob = true;
+
+    for (;;)
+    {
+        // Wait for a New Job
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->jobReady.wait(lock, [&] { return pool->generation != seen; });
+        seen = pool->generation;
+        lock.unlock();
+
+        // Work on the Job
+        runChunks();
+
+        // Report Completion
+        lock.lock();
+        if (--pool->pending == 0)
+        {
+            pool->jobDone.notify_one();
+        }
+    }
+}
+
+/**
+ * startThreadPool - Starts the Shared Worker Threads
+ */
+void startThreadPool(int threads)
+{
+    // Only Start the Pool once
+    if (pool != NULL)
+    {
+        return;
+    }
+
+    // Default to one Thread per Hardware Thread
+    if (threads <= 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads <= 0)
+    {
+        threads = 1;
+    }
+
+    // Create the Pool
+    pool = new threadPool();
+    pool->body = NULL;
+    pool->count = 0;
+    pool->grain = 1;
+    pool->next = 0;
+    pool->generation = 0;
+    pool->pending = 0;
+    pool->size = threads;
+
+    // Start the Workers (the caller is the remaining thread)
+    for (int i = 1; i < threads; i++)
+    {
+        std::thread(workerLoop).detach();
+    }
+}
+
+/**
+ * threadPoolSize - Number of Threads working on a Job
+ */
+int threadPoolSize()
+{
+    return (pool != NULL) ? pool->size : 1;
+}
+
+/**
+ * parallelFor - Runs body over [0, count) on the Shared Workers
+ */
+void parallelFor(int count, int grain, const std::function<void(int, int)> & body)
+{
+    // Nothing to do
+    if (count <= 0)
+    {
+        return;
+    }
+
+    if (grain < 1)
+    {
+        grain = 1;
+    }
+
+    // Run the Chunks Serially if there is Nothing to Share, if called
+    // from inside a Job, or if another Thread currently owns the Pool
+    if ((pool == NULL) || (pool->size == 1) || (count <= grain) || insideJob || !pool->owner.try_lock())
+    {
+        for (int begin = 0; begin < count; begin += grain)
+        {
+            body(begin, (begin + grain < count) ? (begin + grain) : count);
+        }
+        return;
+    }
+
+    // Post the Job
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->body = &body;
+        pool->count = count;
+        pool->grain = grain;
+        pool->next = 0;
+        pool->pending = pool->size - 1;
+        pool->generation++;
+    }
+    pool->jobReady.notify_all();
+
+    // Take Part in the Job
+    insideJob = true;
+    runChunks();
+    insideJob = false;
+
+    // Wait for the Workers to Finish
+    {
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->jobDone.wait(lock, [] { return pool->pending == 0; });
+        pool->body = NULL;
+    }
+
+    pool->owner.unlock();
+}
+
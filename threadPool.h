@@ -0,0 +1,27 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <functional>
+
+// starts the shared worker threads
+// threads = total number of threads working on a job (including the caller),
+//           a value of 0 means one thread per hardware thread
+void startThreadPool(int threads);
+
+// number of threads working on a job (including the caller)
+int threadPoolSize();
+
+// runs body(begin, end) over the range [0, count) in chunks of 'grain' items
+// chunks are handed out dynamically, so uneven chunks balance themselves out
+// calls made from inside a job, or while another thread owns the pool, run the chunks serially
+void parallelFor(int count, int grain, const std::function<void(int, int)> & body);
+
+#endif
+
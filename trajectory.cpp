@@ -0,0 +1,260 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "trajectory.h"
+#include "deltaCodec.h"
+#include "frameWriter.h"
+#include <string>
+#include <vector>
+
+// State of the Scene after a Timestep, Waiting for the Writer
+struct recordedFrame
+{
+    bool reset;
+    long step;
+    double time;
+    std::vector<struct point> p; // positions of every body, in body order
+    std::vector<struct point> v; // velocities of every body (if recorded)
+};
+
+// Recorder State (never freed, see frameWriter.h)
+struct trajectoryRecorder
+{
+    frameWriter<struct recordedFrame> writer;
+    writtenFile file;
+    int encoding;
+    int velocities;
+    int bodies;
+
+    // Writer State
+    std::vector<unsigned char> values;      // encoded values of the current frame
+    std::vector<long long> previous;        // quantized values of the previous frame
+    std::vector<int64_t> offsets;           // file offset of every frame
+    long sinceKeyframe;                     // frames since the last keyframe
+
+    trajectoryRecorder() : writer(TRAJECTORY_BUFFERS), sinceKeyframe(0) {}
+};
+
+static struct trajectoryRecorder * recorder = NULL;
+
+/**
+ * encodeValues - Encodes 512 Points into the Values of the Frame
+ *
+ * @param first - Index of the First Value in the Quantized Values
+ */
+static void encodeValues(const struct point * points, size_t first, bool keyframe)
+{
+    std::vector<unsigned char> & values = recorder->values;
+    size_t count = 3 * 512;
+    const double * coordinates = &points[0].x;
+
+    if (recorder->encoding == TRAJECTORY_DOUBLE)
+    {
+        const unsigned char * bytes = (const unsigned char *) coordinates;
+        values.insert(values.end(), bytes, bytes + count * sizeof(double));
+    }
+    else if (recorder->encoding == TRAJECTORY_FLOAT)
+    {
+        size_t start = values.size();
+        values.resize(start + count * sizeof(float));
+        float * out = (float *) &values[start];
+        for (size_t i=0; i<count; i++)
+        {
+            out[i] = (float) coordinates[i];
+        }
+    }
+    else
+    {
+        size_t start = values.size();
+        values.resize(start + count * VARINT_MAX_BYTES);
+        unsigned char * out = &values[start];
+        long long * previous = &recorder->previous[first];
+
+        for (size_t i=0; i<count; i++)
+        {
+            long long quantized = quantize(coordinates[i], TRAJECTORY_QUANTUM);
+            out = putVarint(out, zigzag(quantized - (keyframe ? 0 : previous[i])));
+            previous[i] = quantized;
+        }
+        values.resize(out - &values[0]);
+    }
+}
+
+/**
+ * writeFrame - Encodes a Queued Frame and Appends it to the
+ *              File (on the Writer Thread)
+ */
+static void writeFrame(struct recordedFrame * frame)
+{
+    // Every Frame not Delta Encoded is a Keyframe
+    bool keyframe = (recorder->encoding != TRAJECTORY_DELTA) || frame->reset ||
+                    (recorder->sinceKeyframe % TRAJECTORY_KEYFRAME_INTERVAL == 0);
+    recorder->sinceKeyframe = keyframe ? 1 : recorder->sinceKeyframe + 1;
+
+    // Positions then Velocities of every Body
+    recorder->values.clear();
+    size_t valuesPerBody = 3 * 512 * (recorder->velocities ? 2 : 1);
+    for (int b=0; b<recorder->bodies; b++)
+    {
+        encodeValues(&frame->p[512 * b], valuesPerBody * b, keyframe);
+
+        if (recorder->velocities)
+        {
+            encodeValues(&frame->v[512 * b], valuesPerBody * b + 3 * 512, keyframe);
+        }
+    }
+
+    struct trajectoryFrame header;
+    memcpy(header.tag, "FRME", 4);
+    header.size = recorder->values.size();
+    header.keyframe = keyframe ? 1 : 0;
+    header.reserved = 0;
+    header.step = frame->step;
+    header.time = frame->time;
+
+    recorder->offsets.push_back(recorder->file.bytes);
+    recorder->file.write(&header, sizeof(header));
+    recorder->file.write(recorder->values.data(), recorder->values.size());
+}
+
+/**
+ * startRecorder - Writes the Header and Starts the Writer Thread
+ */
+int startRecorder(const char * fileName, struct scene * scene, int encoding, int velocities)
+{
+    if (recorder != NULL)
+    {
+        return 1;
+    }
+
+    recorder = new trajectoryRecorder();
+    if (!recorder->file.open(fileName, "wb"))
+    {
+        delete recorder;
+        recorder = NULL;
+        return 0;
+    }
+
+    recorder->encoding = encoding;
+    recorder->velocities = velocities;
+    recorder->bodies = scene->bodies.size();
+    recorder->previous.resize(3 * 512 * (velocities ? 2 : 1) * recorder->bodies);
+    setvbuf(recorder->file.file, NULL, _IOFBF, TRAJECTORY_IO_BUFFER);
+
+    // Static Parameters, once
+    struct trajectoryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRAJECTORY_MAGIC, 8);
+    header.version = TRAJECTORY_VERSION;
+    header.bodies = recorder->bodies;
+    header.encoding = encoding;
+    header.velocities = velocities;
+    header.keyframeInterval = (encoding == TRAJECTORY_DELTA) ? TRAJECTORY_KEYFRAME_INTERVAL : 1;
+    header.n = scene->n;
+    header.dt = scene->dt;
+    header.quantum = TRAJECTORY_QUANTUM;
+    recorder->file.write(&header, sizeof(header));
+
+    for (int b=0; b<recorder->bodies; b++)
+    {
+        struct world * jello = scene->bodies[b];
+        struct trajectoryBody body;
+        memset(&body, 0, sizeof(body));
+        strncpy(body.file, scene->files[b].c_str(), sizeof(body.file) - 1);
+        strncpy(body.integrator, jello->integrator, sizeof(body.integrator) - 1);
+        body.kElastic = jello->kElastic;
+        body.dElastic = jello->dElastic;
+        body.kCollision = jello->kCollision;
+        body.dCollision = jello->dCollision;
+        body.mass = jello->mass;
+        body.a = jello->a;
+        body.b = jello->b;
+        body.c = jello->c;
+        body.d = jello->d;
+        body.incPlanePresent = jello->incPlanePresent;
+        body.resolution = jello->resolution;
+        recorder->file.write(&body, sizeof(body));
+
+        int fieldPoints = jello->resolution * jello->resolution * jello->resolution;
+        recorder->file.write(jello->forceField, fieldPoints * sizeof(struct point));
+    }
+
+    // Frames Reused by the Recording Thread
+    for (int i=0; i<TRAJECTORY_BUFFERS; i++)
+    {
+        struct recordedFrame * frame = new recordedFrame();
+        frame->p.resize(512 * recorder->bodies);
+        frame->v.resize(velocities ? 512 * recorder->bodies : 0);
+        recorder->writer.addFrame(frame);
+    }
+
+    recorder->writer.start(1, writeFrame);
+    atexit(stopRecorder);
+
+    // Start with the Initial State
+    recordScene(scene, true);
+
+    return 1;
+}
+
+/**
+ * recordScene - Queues the Current State of the Scene
+ */
+void recordScene(struct scene * scene, bool reset)
+{
+    struct recordedFrame * frame;
+    if ((recorder == NULL) || ((frame = recorder->writer.acquire()) == NULL))
+    {
+        return;
+    }
+
+    frame->reset = reset;
+    frame->step = scene->steps;
+    frame->time = scene->time;
+
+    for (int b=0; b<recorder->bodies; b++)
+    {
+        memcpy(&frame->p[512 * b], scene->bodies[b]->p, 512 * sizeof(struct point));
+        if (recorder->velocities)
+        {
+            memcpy(&frame->v[512 * b], scene->bodies[b]->v, 512 * sizeof(struct point));
+        }
+    }
+
+    recorder->writer.submit(frame);
+}
+
+/**
+ * stopRecorder - Writes the Queued Frames and the Index, and Closes the File
+ */
+void stopRecorder()
+{
+    if ((recorder == NULL) || (recorder->file.file == NULL))
+    {
+        return;
+    }
+
+    // Drain the Queue, and Stop Handing out Frames to the Recording Thread
+    recorder->writer.stop();
+
+    // Index of the Frames
+    struct trajectoryEnd end;
+    end.index = recorder->file.bytes;
+    memcpy(end.magic, TRAJECTORY_END_MAGIC, 8);
+
+    int64_t frames = recorder->offsets.size();
+    recorder->file.write("INDX", 4);
+    recorder->file.write(&frames, sizeof(frames));
+    recorder->file.write(recorder->offsets.data(), frames * sizeof(int64_t));
+    recorder->file.write(&end, sizeof(end));
+    recorder->file.close();
+
+    printf("Saved %ld frames to %s\n", (long) frames, recorder->file.name.c_str());
+}
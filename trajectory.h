@@ -0,0 +1,99 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _TRAJECTORY_H_
+#define _TRAJECTORY_H_
+
+#include <stdint.h>
+
+// Trajectory File (native byte order):
+//   trajectoryHeader
+//   one trajectoryBody per body, each followed by its resolution^3 force field points (3 doubles)
+//   trajectoryFrame chunks, each followed by 'size' bytes of values
+//   an index when the recording was closed: "INDX", the number of frames (int64),
+//   the file offset of every frame (int64), then the trajectoryEnd
+// The values of a frame are, for every body, the 512 positions and then (with
+// velocities) the 512 velocities, x y z each, in the encoding of the header.
+
+#define TRAJECTORY_MAGIC "JELLOTRJ"
+#define TRAJECTORY_END_MAGIC "JELLOEND"
+#define TRAJECTORY_VERSION 1
+
+// encodings of the values
+#define TRAJECTORY_DOUBLE 0 // doubles
+#define TRAJECTORY_FLOAT 1  // floats
+#define TRAJECTORY_DELTA 2  // zigzag varints of the value quantized to 'quantum', minus the
+                            // quantized value of the previous frame (of 0 in keyframes)
+
+// frames between keyframes of delta encoded trajectories
+#define TRAJECTORY_KEYFRAME_INTERVAL 64
+
+// quantum of delta encoded trajectories (units of the bounding box)
+#define TRAJECTORY_QUANTUM 1e-6
+
+// number of frames waiting for the writer thread
+#define TRAJECTORY_BUFFERS 64
+
+// size of the write buffer of the file
+#define TRAJECTORY_IO_BUFFER (1 << 20)
+
+struct trajectoryHeader
+{
+    char magic[8];              // TRAJECTORY_MAGIC
+    int32_t version;            // TRAJECTORY_VERSION
+    int32_t bodies;             // jellos in the scene
+    int32_t encoding;           // TRAJECTORY_DOUBLE, TRAJECTORY_FLOAT or TRAJECTORY_DELTA
+    int32_t velocities;         // 1 if the frames hold the velocities
+    int32_t keyframeInterval;   // frames between keyframes (1 if every frame is one)
+    int32_t n;                  // timesteps per rendered frame
+    double dt;                  // timestep
+    double quantum;             // quantum of the delta encoding
+};
+
+// static parameters of a body, as they were when the recording started
+struct trajectoryBody
+{
+    char file[256];             // world file
+    char integrator[16];
+    double kElastic, dElastic, kCollision, dCollision, mass;
+    double a, b, c, d;
+    int32_t incPlanePresent;
+    int32_t resolution;         // force field points per side, followed by the force field
+};
+
+struct trajectoryFrame
+{
+    char tag[4];                // "FRME"
+    uint32_t size;              // bytes of values after the frame header
+    int32_t keyframe;           // 1 if the values don't depend on the previous frame
+    int32_t reserved;
+    int64_t step;               // timesteps performed
+    double time;                // simulated time
+};
+
+struct trajectoryEnd
+{
+    int64_t index;              // file offset of the index
+    char magic[8];              // TRAJECTORY_END_MAGIC
+};
+
+// starts the thread writing a trajectory of 'scene' to 'fileName', with the values
+// in 'encoding' (and the velocities if 'velocities'), and records the current state.
+// stopRecorder is registered with atexit. Returns 0 if the file can't be created.
+int startRecorder(const char * fileName, struct scene * scene, int encoding, int velocities);
+
+// queues the current state of the scene for the writer, waiting while all the frames
+// are queued. Call it from the thread stepping the scene, after every timestep.
+// 'reset' forces a keyframe (e.g. after a world file was reloaded). Does nothing
+// if no recording was started.
+void recordScene(struct scene * scene, bool reset);
+
+// writes the queued frames and the index, and closes the file
+void stopRecorder();
+
+#endif
+
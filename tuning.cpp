@@ -0,0 +1,233 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+// Headers
+#include "jello.h"
+#include "scene.h"
+#include "simulation.h"
+#include "tuning.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+// Represents the Double-Buffered, Seqlock-Protected Parameter Block
+// The writers fill the buffer the physics thread is not reading and flip
+// to it; the physics thread copies the published buffer without locking,
+// and retries if a writer reached that buffer again meanwhile. The buffers
+// are plain arrays allocated once by startTuning and copied element by
+// element, so a torn copy never touches memory being reallocated.
+struct parameterBlock
+{
+    std::atomic<unsigned> sequence;                 // odd while a writer fills a buffer, published buffer = (sequence / 2) % 2
+    struct parameters * buffer[2];                  // parameters of every body
+    struct parameters * copy;                       // last copy of the published buffer (physics thread only)
+    int bodies;                                     // length of the arrays
+    std::mutex writer;                              // serializes the writers (never taken by the physics thread)
+    std::vector<struct parameters> values;          // newest parameters, owned by the writers
+    unsigned applied;                               // sequence last copied into the bodies (physics thread only)
+};
+
+static struct parameterBlock block;
+
+// Parameter changed by tuneParameter
+static int selected = 0;
+
+// Names of the Parameters
+static const char * parameterNames[TUNING_PARAMETERS] = { "kElastic", "dElastic", "kCollision", "dCollision", "mass" };
+
+/**
+ * parameterField - Gets one Parameter of a Parameter Set by Number
+ */
+static double & parameterField(struct parameters & values, int parameter)
+{
+    switch (parameter)
+    {
+        case 0:  return values.kElastic;
+        case 1:  return values.dElastic;
+        case 2:  return values.kCollision;
+        case 3:  return values.dCollision;
+        default: return values.mass;
+    }
+}
+
+/**
+ * publishParameters - Copies the Newest Parameters into the Idle
+ *                     Buffer and Flips to it (writer mutex held)
+ */
+static void publishParameters()
+{
+    unsigned sequence = block.sequence.load(std::memory_order_relaxed);
+
+    // Mark the Write as in Progress
+    block.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Fill the Buffer that is not Published
+    struct parameters * buffer = block.buffer[((sequence / 2) + 1) % 2];
+    for (int b=0; b<block.bodies; b++)
+    {
+        buffer[b] = block.values[b];
+    }
+
+    // Publish it
+    block.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * startTuning - Initializes the Parameter Block from the Bodies
+ */
+void startTuning(struct scene * scene)
+{
+    std::lock_guard<std::mutex> lock(block.writer);
+
+    block.values.resize(scene->bodies.size());
+    for (size_t b=0; b<scene->bodies.size(); b++)
+    {
+        struct world * jello = scene->bodies[b];
+
+        block.values[b].kElastic = jello->kElastic;
+        block.values[b].dElastic = jello->dElastic;
+        block.values[b].kCollision = jello->kCollision;
+        block.values[b].dCollision = jello->dCollision;
+        block.values[b].mass = jello->mass;
+    }
+
+    // Both Buffers hold the Starting Parameters, which the Bodies already have
+    block.bodies = (int) block.values.size();
+    for (int i=0; i<2; i++)
+    {
+        block.buffer[i] = new parameters[block.bodies];
+        std::copy(block.values.begin(), block.values.end(), block.buffer[i]);
+    }
+    block.copy = new parameters[block.bodies];
+    block.applied = block.sequence.load();
+}
+
+/**
+ * selectParameter - Selects the Parameter to Tune
+ */
+void selectParameter(int parameter)
+{
+    if ((parameter < 0) || (parameter >= TUNING_PARAMETERS))
+    {
+        return;
+    }
+
+    selected = parameter;
+
+    std::lock_guard<std::mutex> lock(block.writer);
+    if (!block.values.empty())
+    {
+        printf("Tuning %s (body 0: %lf)\n", parameterNames[selected], parameterField(block.values[0], selected));
+    }
+}
+
+/**
+ * tuneParameter - Scales the Selected Parameter of every Body
+ */
+void tuneParameter(double factor)
+{
+    {
+        std::lock_guard<std::mutex> lock(block.writer);
+
+        if (block.values.empty())
+        {
+            return;
+        }
+
+        for (size_t b=0; b<block.values.size(); b++)
+        {
+            parameterField(block.values[b], selected) *= factor;
+        }
+
+        publishParameters();
+
+        printf("%s = %lf (body 0)\n", parameterNames[selected], parameterField(block.values[0], selected));
+    }
+
+    // Let a Sleeping Scene see the Change
+    notifySimulation();
+}
+
+/**
+ * setParameters - Replaces the Parameters of one Body
+ */
+void setParameters(int body, const struct parameters & values)
+{
+    {
+        std::lock_guard<std::mutex> lock(block.writer);
+
+        if ((body < 0) || (body >= (int)block.values.size()))
+        {
+            return;
+        }
+
+        block.values[body] = values;
+        publishParameters();
+    }
+
+    // Let a Sleeping Scene see the Change
+    notifySimulation();
+}
+
+/**
+ * applyTuning - Copies the Newest Parameters into the Bodies
+ */
+int applyTuning(struct scene * scene)
+{
+    unsigned begin = block.sequence.load(std::memory_order_acquire);
+
+    // Nothing Published since the last Copy
+    if ((begin & ~1u) == block.applied)
+    {
+        return 0;
+    }
+
+    // Copy the Published Buffer until no Writer got to it meanwhile
+    // (a writer only reaches it again two flips later)
+    struct parameters * values = block.copy;
+    for (;;)
+    {
+        const struct parameters * buffer = block.buffer[(begin / 2) % 2];
+        for (int b=0; b<block.bodies; b++)
+        {
+            values[b] = buffer[b];
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned end = block.sequence.load(std::memory_order_relaxed);
+
+        if (end - (begin & ~1u) < 3)
+        {
+            break;
+        }
+
+        begin = block.sequence.load(std::memory_order_acquire);
+    }
+    block.applied = begin & ~1u;
+
+    // Set the Parameters of every Body
+    for (int b=0; (b<(int)scene->bodies.size()) && (b<block.bodies); b++)
+    {
+        struct world * jello = scene->bodies[b];
+
+        jello->kElastic = values[b].kElastic;
+        jello->dElastic = values[b].dElastic;
+        jello->kCollision = values[b].kCollision;
+        jello->dCollision = values[b].dCollision;
+        jello->mass = values[b].mass;
+
+        // Recompute the Derived Constants once per Update
+        jello->invMass = 1.0 / jello->mass;
+
+        // The Forces have Changed
+        wakeBody(jello);
+    }
+
+    return 1;
+}
@@ -0,0 +1,45 @@
+/*                                              */
+/*  CSCI 520 Computer Animation and Simulation  */
+/*  Assignment 1: Jello Cube                    */
+/*  Author: Matthew Robinson                    */
+/*  Student Id: 9801107811                      */
+/*                                              */
+
+#ifndef _TUNING_H_
+#define _TUNING_H_
+
+// Represents the Physical Parameters of a Jello that can be changed while it runs
+struct parameters
+{
+    double kElastic;   // Hook's elasticity coefficient for all springs except collision springs
+    double dElastic;   // Damping coefficient for all springs except collision springs
+    double kCollision; // Hook's elasticity coefficient for collision springs
+    double dCollision; // Damping coefficient collision springs
+    double mass;       // mass of each of the 512 control points
+};
+
+// number of parameters in struct parameters
+#define TUNING_PARAMETERS 5
+
+// copies the parameters of every body of the scene into the parameter block
+// (call before the physics thread starts)
+void startTuning(struct scene * scene);
+
+// selects the parameter changed by tuneParameter (0 = kElastic ... 4 = mass)
+void selectParameter(int parameter);
+
+// multiplies the selected parameter of every body by 'factor' and publishes
+// the new parameters to the physics thread (user interface thread)
+void tuneParameter(double factor);
+
+// replaces the parameters of one body and publishes them (any thread)
+void setParameters(int body, const struct parameters & values);
+
+// copies the newest parameters into the bodies if they changed, recomputing
+// the derived constants and waking up the bodies. Lock-free, called by the
+// physics thread at step boundaries.
+// returns 1 if the parameters changed, 0 otherwise
+int applyTuning(struct scene * scene);
+
+#endif
+